@@ -0,0 +1,261 @@
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// =============================================================================
+// Binary Log Decoder - companion tool for BinaryLogger (polymorphism_hints.cpp)
+// =============================================================================
+
+/*
+ * BinaryLogger writes format ids and raw argument bytes instead of text.
+ * This program reads such a file and renders the text that was "deferred":
+ *
+ *   BINLOG(logger, LogLevel::Info, "Processed request {} in {} us", 42, 17);
+ *
+ * becomes
+ *
+ *   [    0.012345 ms] T0 INFO: Processed request 42 in 17 us
+ *
+ * FILE FORMAT (see PART 5 of polymorphism_hints.cpp; integers are varints)
+ *   header      "BINLOG01", double ns_per_tick, uint64 start_tick
+ *   'D' entry   varint id, level byte, varint len + format, varint len + signature
+ *   'B' block   varint thread index, varint byte count, then records
+ *   record      varint id, varint timestamp delta, then the arguments
+ *
+ * The file describes itself: the dictionary entries travel inside the log,
+ * so the decoder does not need to be rebuilt when call sites change.
+ */
+
+struct FormatEntry {
+    int level;
+    std::string format;
+    std::string signature;
+};
+
+/*
+ * ByteReader - walks through a byte buffer and reports truncated input
+ * by returning false instead of reading past the end
+ */
+class ByteReader {
+private:
+    const std::string& bytes;
+    size_t pos;
+    size_t end;
+
+public:
+    ByteReader(const std::string& data, size_t start, size_t stop)
+        : bytes(data), pos(start), end(stop) {}
+
+    bool at_end() const { return pos >= end; }
+    size_t position() const { return pos; }
+    void skip_to(size_t new_pos) { pos = new_pos; }
+
+    bool read_byte(uint8_t& value) {
+        if (pos >= end) return false;
+        value = static_cast<uint8_t>(bytes[pos++]);
+        return true;
+    }
+
+    bool read_varint(uint64_t& value) {
+        value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            uint8_t byte;
+            if (!read_byte(byte)) return false;
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) return true;
+        }
+        return false;  // Too many continuation bytes - corrupt file
+    }
+
+    bool read_raw(void* destination, size_t count) {
+        if (end - pos < count) return false;
+        std::memcpy(destination, bytes.data() + pos, count);
+        pos += count;
+        return true;
+    }
+
+    bool read_string(std::string& value) {
+        uint64_t length;
+        if (!read_varint(length) || end - pos < length) return false;
+        value.assign(bytes, pos, length);
+        pos += length;
+        return true;
+    }
+};
+
+const char* level_prefix(int level) {
+    switch (level) {
+        case 0:  return "INFO: ";
+        case 1:  return "WARNING: ";
+        case 2:  return "ERROR: ";
+        default: return "";  // Level 'Off' marks plain text records
+    }
+}
+
+// Reads one argument according to its signature letter and appends it as text
+bool render_argument(ByteReader& reader, char tag, std::string& out) {
+    uint64_t raw;
+    switch (tag) {
+        case 'i': {
+            if (!reader.read_varint(raw)) return false;
+            // Undo the zigzag encoding: 0,1,2,3 -> 0,-1,1,-2
+            int64_t value = static_cast<int64_t>(raw >> 1) ^ -static_cast<int64_t>(raw & 1);
+            out += std::to_string(value);
+            return true;
+        }
+        case 'u':
+            if (!reader.read_varint(raw)) return false;
+            out += std::to_string(raw);
+            return true;
+        case 'd': {
+            double value;
+            if (!reader.read_raw(&value, sizeof(value))) return false;
+            std::ostringstream formatted;
+            formatted << value;
+            out += formatted.str();
+            return true;
+        }
+        case 's': {
+            std::string value;
+            if (!reader.read_string(value)) return false;
+            out += value;
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
+// Replaces each "{}" in the format with the next argument
+bool render_record(ByteReader& reader, const FormatEntry& entry, std::string& out) {
+    size_t next_arg = 0;
+    size_t i = 0;
+    while (i < entry.format.size()) {
+        if (entry.format.compare(i, 2, "{}") == 0 && next_arg < entry.signature.size()) {
+            if (!render_argument(reader, entry.signature[next_arg++], out)) return false;
+            i += 2;
+        } else {
+            out += entry.format[i++];
+        }
+    }
+    // Arguments without a placeholder are still consumed (and shown)
+    while (next_arg < entry.signature.size()) {
+        out += ' ';
+        if (!render_argument(reader, entry.signature[next_arg++], out)) return false;
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc != 2) {
+        std::cerr << "Usage: " << argv[0] << " <file.binlog>\n";
+        return 1;
+    }
+
+    std::ifstream in(argv[1], std::ios::binary);
+    if (!in) {
+        std::cerr << "Failed to open: " << argv[1] << "\n";
+        return 1;
+    }
+    std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+    const size_t header_size = 8 + sizeof(double) + sizeof(uint64_t);
+    if (data.size() < header_size || data.compare(0, 8, "BINLOG01") != 0) {
+        std::cerr << "Not a BinaryLogger file: " << argv[1] << "\n";
+        return 1;
+    }
+
+    double ns_per_tick;
+    uint64_t start_tick;
+    std::memcpy(&ns_per_tick, data.data() + 8, sizeof(ns_per_tick));
+    std::memcpy(&start_tick, data.data() + 8 + sizeof(double), sizeof(start_tick));
+
+    std::unordered_map<uint64_t, FormatEntry> dictionary;
+    std::unordered_map<uint64_t, uint64_t> last_tick;  // Timestamps are per-thread deltas
+
+    ByteReader reader(data, header_size, data.size());
+    std::string line;
+    size_t record_count = 0;
+
+    while (!reader.at_end()) {
+        uint8_t tag;
+        reader.read_byte(tag);
+
+        if (tag == 'D') {
+            uint64_t id;
+            uint8_t level;
+            FormatEntry entry;
+            if (!reader.read_varint(id) || !reader.read_byte(level) ||
+                !reader.read_string(entry.format) || !reader.read_string(entry.signature)) {
+                std::cerr << "Truncated dictionary entry\n";
+                return 1;
+            }
+            entry.level = level;
+            dictionary[id] = entry;
+        } else if (tag == 'B') {
+            uint64_t thread_index, length;
+            if (!reader.read_varint(thread_index) || !reader.read_varint(length) ||
+                data.size() - reader.position() < length) {
+                std::cerr << "Truncated record block\n";
+                return 1;
+            }
+            size_t block_end = reader.position() + length;
+            ByteReader block(data, reader.position(), block_end);
+
+            while (!block.at_end()) {
+                uint64_t id, delta;
+                if (!block.read_varint(id) || !block.read_varint(delta)) {
+                    std::cerr << "Truncated record\n";
+                    return 1;
+                }
+                auto found = dictionary.find(id);
+                if (found == dictionary.end()) {
+                    std::cerr << "Unknown format id " << id << "\n";
+                    return 1;
+                }
+
+                uint64_t tick = (last_tick[thread_index] += delta);
+                double elapsed_ms = tick >= start_tick
+                    ? static_cast<double>(tick - start_tick) * ns_per_tick / 1e6
+                    : 0.0;
+
+                line.clear();
+                line += level_prefix(found->second.level);
+                if (!render_record(block, found->second, line)) {
+                    std::cerr << "Corrupt arguments for format id " << id << "\n";
+                    return 1;
+                }
+                std::cout << "[" << std::fixed << std::setprecision(6) << std::setw(12)
+                          << elapsed_ms << " ms] T" << thread_index << " " << line << "\n";
+                ++record_count;
+            }
+            reader.skip_to(block_end);
+        } else {
+            std::cerr << "Unknown entry tag '" << static_cast<char>(tag) << "'\n";
+            return 1;
+        }
+    }
+
+    std::cerr << "Decoded " << record_count << " records\n";
+    return 0;
+}
+
+/*
+COMPILATION:
+    g++ -std=c++17 -Wall -Wextra binary_log_decoder.cpp -o binary_log_decoder
+
+EXECUTION:
+    ./polymorphism_demo                              (writes requests.binlog)
+    ./binary_log_decoder requests.binlog > requests.txt
+
+NOTES:
+    - Records are printed block by block; within one thread they are in
+      order, but blocks from different threads may interleave
+    - Timestamps are relative to when the logger was created
+*/
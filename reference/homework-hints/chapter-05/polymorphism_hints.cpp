@@ -1,8 +1,28 @@
 #include <iostream>
 #include <string>
 #include <fstream>
+#include <sstream>
 #include <vector>
 #include <cmath>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <variant>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>  // __rdtsc() - cheapest possible timestamp on x86
+#define BINLOG_HAS_RDTSC 1
+#endif
 
 // =============================================================================
 // PART 1: Basic Inheritance and Virtual Functions
@@ -186,6 +206,15 @@ public:
 // PART 3: Advanced Logging System (Practical Polymorphism)
 // =============================================================================
 
+/*
+ * Log Levels
+ *
+ * Every message has a severity. Each logger has a minimum level and simply
+ * ignores anything below it. 'Off' is higher than every real level, so a
+ * logger set to 'Off' accepts nothing.
+ */
+enum class LogLevel { Info = 0, Warning = 1, Error = 2, Off = 3 };
+
 /*
  * Logger Interface
  *
@@ -195,23 +224,117 @@ public:
  * The Application class can work with ANY logger implementation!
  */
 class Logger {
+private:
+    LogLevel min_level = LogLevel::Info;
+    std::vector<Logger*> watchers;  // Loggers that follow this one's level (MultiLogger)
+    std::vector<Logger*> watched;   // Loggers whose level this one follows
+
+    static void forget(std::vector<Logger*>& list, Logger* logger) {
+        list.erase(std::remove(list.begin(), list.end(), logger), list.end());
+    }
+
 public:
-    virtual ~Logger() = default;
+    Logger() = default;
+
+    // A copy has the same level, but nobody watches it yet
+    Logger(const Logger& other) : min_level(other.min_level) {}
+    Logger& operator=(const Logger& other) {
+        set_level(other.min_level);
+        return *this;
+    }
+
+    virtual ~Logger() {
+        for (Logger* destination : watched) forget(destination->watchers, this);
+        for (Logger* watcher : watchers) forget(watcher->watched, this);
+    }
 
     // Pure virtual - must be implemented by all loggers
     virtual void log(const std::string& message) const = 0;
 
+    // Level filtering - is_enabled() is NOT virtual, so the check compiles
+    // down to one load and one compare at every call site, for every kind
+    // of logger. A logger that forwards to others (MultiLogger) keeps its
+    // level equal to the lowest level of its destinations: set_level() on
+    // a destination tells it (see watch_level), so that cached value is
+    // never stale and no check has to loop over the destinations.
+    void set_level(LogLevel level) {
+        min_level = level;
+        for (Logger* watcher : watchers) watcher->watched_level_changed();
+    }
+    LogLevel get_level() const { return min_level; }
+    bool is_enabled(LogLevel level) const { return level >= min_level; }
+
+protected:
+    // From now on, set_level() on 'destination' calls watched_level_changed()
+    void watch_level(Logger* destination) {
+        destination->watchers.push_back(this);
+        watched.push_back(destination);
+    }
+
+    virtual void watched_level_changed() {}
+
+public:
     // Convenience methods with default implementations
+    // The level is checked BEFORE building "ERROR: " + message, so a
+    // disabled logger never allocates
     virtual void log_error(const std::string& message) const {
-        log("ERROR: " + message);
+        if (is_enabled(LogLevel::Error)) log_record(LogLevel::Error, "ERROR: " + message);
     }
 
     virtual void log_warning(const std::string& message) const {
-        log("WARNING: " + message);
+        if (is_enabled(LogLevel::Warning)) log_record(LogLevel::Warning, "WARNING: " + message);
     }
 
     virtual void log_info(const std::string& message) const {
-        log("INFO: " + message);
+        if (is_enabled(LogLevel::Info)) log_record(LogLevel::Info, "INFO: " + message);
+    }
+
+    /*
+     * Lazy logging front end
+     *
+     *   logger->info("Starting task: ", task_name);
+     *
+     * The pieces are passed separately (by reference) instead of being glued
+     * together with '+' at the call site. They are only formatted into one
+     * string after the level check passes, so a disabled call costs a single
+     * predictable branch - no string building, no heap allocation.
+     * An enabled call ends up in log_info()/log_warning()/log_error(), so a
+     * logger that overrides those sees these calls too.
+     */
+    template<typename... Args>
+    void info(const Args&... args) const {
+        if (is_enabled(LogLevel::Info)) emit(LogLevel::Info, args...);
+    }
+
+    template<typename... Args>
+    void warning(const Args&... args) const {
+        if (is_enabled(LogLevel::Warning)) emit(LogLevel::Warning, args...);
+    }
+
+    template<typename... Args>
+    void error(const Args&... args) const {
+        if (is_enabled(LogLevel::Error)) emit(LogLevel::Error, args...);
+    }
+
+    // Receives a message that already passed the level check.
+    // Most loggers just write it; MultiLogger overrides this to route the
+    // message only to the destinations that accept its level.
+    virtual void log_record(LogLevel /* level */, const std::string& message) const {
+        log(message);
+    }
+
+private:
+    // Slow path - only reached when the message will actually be written
+    template<typename... Args>
+    void emit(LogLevel level, const Args&... args) const {
+        std::ostringstream formatted;
+        (formatted << ... << args);  // C++17 fold expression: streams every argument
+        switch (level) {
+            case LogLevel::Info:    log_info(formatted.str()); break;
+            case LogLevel::Warning: log_warning(formatted.str()); break;
+            case LogLevel::Error:   log_error(formatted.str()); break;
+            default:                break;
+        }
     }
 };
 
@@ -265,6 +388,10 @@ public:
  */
 class SilentLogger : public Logger {
 public:
+    // Level 'Off' makes every info()/warning()/error() call return after one
+    // branch - the message is never even formatted
+    SilentLogger() { set_level(LogLevel::Off); }
+
     void log(const std::string& /* message */) const override {
         // Intentionally does nothing
         // Parameter commented out to avoid unused parameter warning
@@ -281,8 +408,13 @@ private:
     std::vector<Logger*> loggers;
 
 public:
+    // With no destinations there is nobody to accept a message
+    MultiLogger() { set_level(LogLevel::Off); }
+
     void add_logger(Logger* logger) {
         loggers.push_back(logger);
+        watch_level(logger);
+        watched_level_changed();
     }
 
     void log(const std::string& message) const override {
@@ -290,6 +422,24 @@ public:
             logger->log(message);
         }
     }
+
+    // The message is formatted once, then each destination filters by level
+    void log_record(LogLevel level, const std::string& message) const override {
+        for (const auto& logger : loggers) {
+            if (logger->is_enabled(level)) {
+                logger->log_record(level, message);
+            }
+        }
+    }
+
+protected:
+    // A level is accepted if ANY destination accepts it. Runs only when a
+    // destination is added or changes its level, never per message.
+    void watched_level_changed() override {
+        LogLevel lowest = LogLevel::Off;
+        for (const auto& logger : loggers) lowest = std::min(lowest, logger->get_level());
+        set_level(lowest);
+    }
 };
 
 // =============================================================================
@@ -318,7 +468,7 @@ public:
         : logger(log), app_name(name) {}
 
     void run() {
-        logger->log_info("Application '" + app_name + "' started");
+        logger->info("Application '", app_name, "' started");
 
         // Simulate some work
         perform_task("Data Processing");
@@ -326,27 +476,1294 @@ public:
 
         // Simulate an error scenario
         if (!handle_error_scenario()) {
-            logger->log_error("Critical error occurred!");
+            logger->error("Critical error occurred!");
         }
 
-        logger->log_info("Application '" + app_name + "' finished");
+        logger->info("Application '", app_name, "' finished");
     }
 
 private:
     void perform_task(const std::string& task_name) {
-        logger->log_info("Starting task: " + task_name);
+        // Pieces are passed separately: with a SilentLogger (or any logger set
+        // above Info) these lines cost one branch each and build no strings
+        logger->info("Starting task: ", task_name);
         // ... actual work happens here ...
-        logger->log_info("Completed task: " + task_name);
+        logger->info("Completed task: ", task_name);
     }
 
     bool handle_error_scenario() {
-        logger->log_warning("Potential issue detected");
+        logger->warning("Potential issue detected");
         logger->log("Attempting recovery...");
         // Simulate recovery failure
         return false;
     }
 };
 
+// =============================================================================
+// PART 4: Asynchronous File Logging (Performance-Minded Polymorphism)
+// =============================================================================
+
+/*
+ * Why FileLogger is slow
+ *
+ * FileLogger::log() opens the file, writes one line and closes it again for
+ * EVERY message. Opening and closing a file are system calls, so a busy
+ * application spends most of its logging time talking to the OS.
+ *
+ * AsyncFileLogger fixes this with three ideas:
+ * 1. The file is opened ONCE and kept open (RAII - closed in the destructor)
+ * 2. log() only hands the message to a queue and returns immediately
+ * 3. A background "writer" thread collects messages into a big batch and
+ *    writes the batch in one go
+ *
+ * Because AsyncFileLogger is still a Logger, the Application class does not
+ * need to change at all - that is the power of programming to an interface!
+ */
+
+/*
+ * BoundedMpscQueue - a lock-free multi-producer, single-consumer queue
+ *
+ * Many threads may call push() at the same time, but only the writer thread
+ * calls pop(). Each slot carries a sequence number that tells producers and
+ * the consumer whose turn it is, so no mutex is needed (this is Dmitry
+ * Vyukov's bounded queue design).
+ *
+ * The capacity is rounded up to a power of two so that "index % capacity"
+ * becomes the much cheaper "index & mask".
+ */
+template<typename T>
+class BoundedMpscQueue {
+private:
+    struct Slot {
+        std::atomic<size_t> sequence{0};
+        T value;
+    };
+
+    std::unique_ptr<Slot[]> slots;
+    size_t mask;
+
+    // Producers and the consumer touch different counters - keep them on
+    // separate cache lines so they do not slow each other down
+    alignas(64) std::atomic<size_t> enqueue_pos{0};
+    alignas(64) size_t dequeue_pos = 0;
+
+public:
+    explicit BoundedMpscQueue(size_t capacity) {
+        size_t rounded = 2;
+        while (rounded < capacity) rounded <<= 1;
+        slots = std::make_unique<Slot[]>(rounded);
+        mask = rounded - 1;
+        for (size_t i = 0; i < rounded; ++i) {
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    BoundedMpscQueue(const BoundedMpscQueue&) = delete;
+    BoundedMpscQueue& operator=(const BoundedMpscQueue&) = delete;
+
+    // Safe to call from any number of threads.
+    // Returns false (and leaves 'value' untouched) when the queue is full.
+    bool try_push(T& value) {
+        size_t pos = enqueue_pos.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot = slots[pos & mask];
+            size_t seq = slot.sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+
+            if (diff == 0) {
+                // The slot is free - try to claim it
+                if (enqueue_pos.compare_exchange_weak(pos, pos + 1,
+                                                      std::memory_order_relaxed)) {
+                    slot.value = std::move(value);
+                    slot.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+                // Another producer won the race; 'pos' now holds the new value
+            } else if (diff < 0) {
+                return false;  // Full: the consumer has not freed this slot yet
+            } else {
+                pos = enqueue_pos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Must only be called from the single consumer thread
+    bool try_pop(T& out) {
+        Slot& slot = slots[dequeue_pos & mask];
+        size_t seq = slot.sequence.load(std::memory_order_acquire);
+        if (seq != dequeue_pos + 1) {
+            return false;  // Empty (or the producer is still writing)
+        }
+        out = std::move(slot.value);
+        // Hand the slot back to producers for the next lap around the ring
+        slot.sequence.store(dequeue_pos + mask + 1, std::memory_order_release);
+        ++dequeue_pos;
+        return true;
+    }
+};
+
+/*
+ * AsyncFileLogger - buffered logger with a background writer thread
+ *
+ * Flush policy: the writer thread writes its batch to the file when
+ * - the batch reaches 'max_batch_bytes', OR
+ * - the oldest unwritten message has waited 'max_delay'
+ * and ALWAYS when the logger is destroyed, so no message is ever lost on a
+ * normal shutdown.
+ *
+ * Note: the owner must make sure no other thread is still calling log()
+ * while the logger is being destroyed (the usual rule for any object).
+ */
+struct FlushPolicy {
+    size_t max_batch_bytes = 64 * 1024;
+    std::chrono::milliseconds max_delay{50};
+};
+
+class AsyncFileLogger : public Logger {
+private:
+    std::string filename;
+    FlushPolicy policy;
+    std::ofstream out;
+
+    // log() is const (it is part of the Logger interface) but it must still
+    // push into the queue - 'mutable' allows exactly that
+    mutable BoundedMpscQueue<std::string> queue;
+
+    std::atomic<bool> stopping{false};
+    std::thread writer;
+
+public:
+    explicit AsyncFileLogger(const std::string& file,
+                             FlushPolicy flush_policy = FlushPolicy(),
+                             size_t queue_capacity = 8192)
+        : filename(file), policy(flush_policy),
+          out(file, std::ios::trunc | std::ios::binary),
+          queue(queue_capacity) {
+        if (!out) {
+            std::cerr << "Failed to open log file: " << filename << "\n";
+        } else {
+            out << "=== Log Session Started ===\n";
+        }
+        // Start the writer only after every member is initialized
+        writer = std::thread(&AsyncFileLogger::writer_loop, this);
+    }
+
+    // Stop the writer thread; it drains the queue and flushes before exiting
+    ~AsyncFileLogger() override {
+        stopping.store(true, std::memory_order_release);
+        writer.join();
+    }
+
+    // Owns a thread and an open file - copying makes no sense
+    AsyncFileLogger(const AsyncFileLogger&) = delete;
+    AsyncFileLogger& operator=(const AsyncFileLogger&) = delete;
+
+    void log(const std::string& message) const override {
+        // Format the complete line here so the writer only has to append bytes
+        std::string line;
+        line.reserve(message.size() + 8);
+        line += "[File] ";
+        line += message;
+        line += '\n';
+
+        // Backpressure: if the writer falls far behind, wait for a free slot
+        // instead of growing memory without bound
+        while (!queue.try_push(line)) {
+            std::this_thread::yield();
+        }
+    }
+
+private:
+    void writer_loop() {
+        using clock = std::chrono::steady_clock;
+
+        std::string batch;
+        batch.reserve(policy.max_batch_bytes * 2);
+        std::string message;
+        auto oldest_pending = clock::now();
+
+        for (;;) {
+            // Read the flag BEFORE draining: every message pushed before the
+            // destructor ran is then guaranteed to be visible below
+            bool stop = stopping.load(std::memory_order_acquire);
+
+            bool received = false;
+            while (queue.try_pop(message)) {
+                if (batch.empty()) oldest_pending = clock::now();
+                batch += message;
+                received = true;
+                if (batch.size() >= policy.max_batch_bytes) {
+                    write_batch(batch);
+                }
+            }
+
+            if (stop) break;
+
+            if (!batch.empty() && clock::now() - oldest_pending >= policy.max_delay) {
+                write_batch(batch);
+            }
+
+            if (!received) {
+                // Nothing to do - sleep briefly instead of spinning
+                auto nap = std::min<std::chrono::milliseconds>(
+                    policy.max_delay, std::chrono::milliseconds(1));
+                std::this_thread::sleep_for(nap);
+            }
+        }
+
+        write_batch(batch);  // Guaranteed flush on shutdown
+    }
+
+    void write_batch(std::string& batch) {
+        if (!batch.empty() && out) {
+            out.write(batch.data(), static_cast<std::streamsize>(batch.size()));
+            out.flush();
+        }
+        batch.clear();  // Keeps its capacity for the next batch
+    }
+};
+
+// =============================================================================
+// PART 5: Binary Logging with Deferred Formatting (NanoLog Style)
+// =============================================================================
+
+/*
+ * Even AsyncFileLogger still FORMATS every message into text on the calling
+ * thread. BinaryLogger skips formatting completely:
+ *
+ *   BINLOG(logger, LogLevel::Info, "Processed request {} in {} us", id, micros);
+ *
+ * - The format string is registered ONCE per call site and gets a small id
+ * - Each call only copies the id, a timestamp and the raw argument bytes into
+ *   a buffer that belongs to the calling thread (no locks, no sharing)
+ * - A background thread copies those buffers to the file
+ * - The separate tool binary_log_decoder.cpp turns the file back into text
+ *
+ * FILE FORMAT (all integers are LEB128 "varints": 7 bits per byte)
+ *   header      "BINLOG01", double ns_per_tick, uint64 start_tick
+ *   'D' entry   varint id, level byte, varint len + format, varint len + signature
+ *   'B' block   varint thread index, varint byte count, then records
+ *   record      varint id, varint timestamp delta, then each argument:
+ *                 'i' signed    zigzag varint
+ *                 'u' unsigned  varint
+ *                 'd' double    8 raw bytes
+ *                 's' string    varint length + bytes
+ *
+ * The signature string holds one letter per argument, so the decoder knows
+ * how to read the bytes. Small numbers take one or two bytes, which is why
+ * binary logs are several times smaller than the text lines FileLogger writes.
+ */
+namespace binlog {
+
+inline std::uint64_t read_timestamp() {
+#ifdef BINLOG_HAS_RDTSC
+    return __rdtsc();
+#else
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+inline std::size_t varint_size(std::uint64_t value) {
+    std::size_t bytes = 1;
+    while (value >= 0x80) {
+        value >>= 7;
+        ++bytes;
+    }
+    return bytes;
+}
+
+// Maps small negative numbers to small unsigned ones: 0,-1,1,-2 -> 0,1,2,3
+inline std::uint64_t zigzag(std::int64_t value) {
+    return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+}
+
+// Strings longer than this are truncated. A record with many long strings
+// can still be bigger than a whole staging buffer; BinaryLogger drops (and
+// counts) such records instead of waiting for room that can never appear.
+constexpr std::size_t max_string_bytes = 4096;
+
+template<typename T>
+struct always_false : std::false_type {};
+
+// One signature letter per argument type, chosen at compile time
+template<typename T>
+constexpr char arg_tag() {
+    if constexpr (std::is_same_v<T, bool>) return 'u';
+    else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) return 'i';
+    else if constexpr (std::is_integral_v<T>) return 'u';
+    else if constexpr (std::is_floating_point_v<T>) return 'd';
+    else if constexpr (std::is_convertible_v<const T&, std::string_view>) return 's';
+    else static_assert(always_false<T>::value, "BINLOG arguments must be numbers or strings");
+}
+
+template<typename... Args>
+std::string signature_of() {
+    return std::string{arg_tag<std::decay_t<Args>>()...};
+}
+
+template<typename T>
+std::size_t encoded_size(const T& value) {
+    constexpr char tag = arg_tag<std::decay_t<T>>();
+    if constexpr (tag == 'i') return varint_size(zigzag(static_cast<std::int64_t>(value)));
+    else if constexpr (tag == 'u') return varint_size(static_cast<std::uint64_t>(value));
+    else if constexpr (tag == 'd') return sizeof(double);
+    else {
+        std::size_t length = std::min(std::string_view(value).size(), max_string_bytes);
+        return varint_size(length) + length;
+    }
+}
+
+/*
+ * RingCursor - writes bytes into a power-of-two ring buffer, wrapping
+ * around at the end
+ */
+struct RingCursor {
+    char* data;
+    std::size_t mask;
+    std::size_t pos;
+
+    void put_byte(std::uint8_t byte) {
+        data[pos++ & mask] = static_cast<char>(byte);
+    }
+
+    void put_bytes(const void* source, std::size_t count) {
+        std::size_t start = pos & mask;
+        std::size_t first = std::min(count, mask + 1 - start);
+        std::memcpy(data + start, source, first);
+        std::memcpy(data, static_cast<const char*>(source) + first, count - first);
+        pos += count;
+    }
+
+    void put_varint(std::uint64_t value) {
+        while (value >= 0x80) {
+            put_byte(static_cast<std::uint8_t>(value) | 0x80);
+            value >>= 7;
+        }
+        put_byte(static_cast<std::uint8_t>(value));
+    }
+};
+
+template<typename T>
+void encode(RingCursor& cursor, const T& value) {
+    constexpr char tag = arg_tag<std::decay_t<T>>();
+    if constexpr (tag == 'i') cursor.put_varint(zigzag(static_cast<std::int64_t>(value)));
+    else if constexpr (tag == 'u') cursor.put_varint(static_cast<std::uint64_t>(value));
+    else if constexpr (tag == 'd') {
+        double as_double = static_cast<double>(value);
+        cursor.put_bytes(&as_double, sizeof(as_double));
+    } else {
+        std::string_view text(value);
+        std::size_t length = std::min(text.size(), max_string_bytes);
+        cursor.put_varint(length);
+        cursor.put_bytes(text.data(), length);
+    }
+}
+
+/*
+ * StagingBuffer - per-thread single-producer/single-consumer byte ring
+ *
+ * Only the owning thread writes (advancing 'head'); only the background
+ * writer reads (advancing 'tail'). head/tail count bytes forever and are
+ * masked on use, so "head - tail" is always the number of unread bytes.
+ */
+class StagingBuffer {
+private:
+    std::unique_ptr<char[]> data;
+    std::size_t mask;
+    alignas(64) std::atomic<std::size_t> head{0};
+    alignas(64) std::atomic<std::size_t> tail{0};
+
+public:
+    const std::uint32_t thread_index;
+    const std::thread::id owner;
+    std::uint64_t last_timestamp = 0;  // Producer only: timestamps are stored as deltas
+    std::size_t cached_tail = 0;       // Producer only: last consumer position seen
+
+    StagingBuffer(std::size_t capacity, std::uint32_t index, std::thread::id owner_id)
+        : data(std::make_unique<char[]>(capacity)), mask(capacity - 1),
+          thread_index(index), owner(owner_id) {}
+
+    std::size_t capacity() const { return mask + 1; }
+
+    // Producer: wait until 'bytes' are free, then return a cursor to write them.
+    // The consumer position is re-read only when the cached copy says the
+    // ring looks full, so the common case never touches the consumer's cache line.
+    // 'bytes' must not exceed capacity(), or the wait would never end.
+    RingCursor reserve(std::size_t bytes) {
+        std::size_t start = head.load(std::memory_order_relaxed);
+        while (start + bytes - cached_tail > mask + 1) {
+            cached_tail = tail.load(std::memory_order_acquire);
+            if (start + bytes - cached_tail > mask + 1) {
+                std::this_thread::yield();  // Writer thread is behind - wait for it
+            }
+        }
+        return RingCursor{data.get(), mask, start};
+    }
+
+    // Producer: publish everything written through the cursor
+    void commit(const RingCursor& cursor) {
+        head.store(cursor.pos, std::memory_order_release);
+    }
+
+    // Consumer: snapshot of the producer position
+    std::size_t published() const {
+        return head.load(std::memory_order_acquire);
+    }
+
+    // Consumer: append the bytes [tail, end) to 'out' and release them
+    void drain_to(std::string& out, std::size_t end) {
+        std::size_t start = tail.load(std::memory_order_relaxed);
+        std::size_t count = end - start;
+        std::size_t offset = start & mask;
+        std::size_t first = std::min(count, mask + 1 - offset);
+        out.append(data.get() + offset, first);
+        out.append(data.get(), count - first);
+        tail.store(end, std::memory_order_release);
+    }
+
+    std::size_t consumed() const {
+        return tail.load(std::memory_order_relaxed);
+    }
+};
+
+struct FormatInfo {
+    LogLevel level;
+    std::string format;
+    std::string signature;
+};
+
+/*
+ * FormatRegistry - process-wide table of call-site formats
+ *
+ * Ids start at 1 so that 0 can mean "this call site is not registered yet".
+ */
+class FormatRegistry {
+private:
+    mutable std::mutex mutex;
+    std::vector<FormatInfo> entries;
+
+public:
+    static FormatRegistry& instance() {
+        static FormatRegistry registry;
+        return registry;
+    }
+
+    std::uint32_t register_site(std::atomic<std::uint32_t>& site, LogLevel level,
+                                const char* format, std::string signature) {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::uint32_t id = site.load(std::memory_order_relaxed);
+        if (id == 0) {  // Another thread may have won the race
+            entries.push_back(FormatInfo{level, format, std::move(signature)});
+            id = static_cast<std::uint32_t>(entries.size());
+            site.store(id, std::memory_order_release);
+        }
+        return id;
+    }
+
+    // Copies the entries with index >= first (ids first+1, first+2, ...)
+    std::vector<FormatInfo> entries_since(std::size_t first) const {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (first >= entries.size()) return {};
+        return std::vector<FormatInfo>(entries.begin() + static_cast<std::ptrdiff_t>(first),
+                                       entries.end());
+    }
+};
+
+}  // namespace binlog
+
+/*
+ * BinaryLogger - a Logger whose fast path never formats text
+ *
+ * Use the BINLOG macro for hot call sites. Plain log()/info() calls still
+ * work (so Application can use a BinaryLogger unchanged); they are stored
+ * as a single string argument.
+ */
+class BinaryLogger : public Logger {
+private:
+    std::string filename;
+    std::ofstream out;
+    std::size_t buffer_capacity;
+    std::uint64_t logger_id;
+
+    mutable std::mutex buffers_mutex;
+    mutable std::vector<std::shared_ptr<binlog::StagingBuffer>> buffers;
+    mutable std::atomic<std::uint64_t> oversized{0};  // Records too big for a thread buffer
+
+    std::atomic<bool> stopping{false};
+    std::thread writer;
+    std::size_t dictionary_written = 0;  // Writer thread only
+
+    static std::uint64_t next_logger_id() {
+        static std::atomic<std::uint64_t> counter{0};
+        return ++counter;
+    }
+
+public:
+    // 'per_thread_buffer' is rounded up to a power of two (minimum 64 KB)
+    explicit BinaryLogger(const std::string& file, std::size_t per_thread_buffer = 1 << 20)
+        : filename(file), out(file, std::ios::trunc | std::ios::binary),
+          buffer_capacity(64 * 1024), logger_id(next_logger_id()) {
+        while (buffer_capacity < per_thread_buffer) buffer_capacity <<= 1;
+
+        if (!out) {
+            std::cerr << "Failed to open log file: " << filename << "\n";
+        }
+        write_header();
+        writer = std::thread(&BinaryLogger::writer_loop, this);
+    }
+
+    ~BinaryLogger() override {
+        stopping.store(true, std::memory_order_release);
+        writer.join();
+        if (dropped_records() > 0) {
+            std::cerr << filename << ": dropped " << dropped_records()
+                      << " records larger than the " << buffer_capacity << "-byte thread buffer\n";
+        }
+    }
+
+    BinaryLogger(const BinaryLogger&) = delete;
+    BinaryLogger& operator=(const BinaryLogger&) = delete;
+
+    // Records that could not be stored because they are bigger than a whole
+    // thread buffer (pass a larger 'per_thread_buffer' to keep them)
+    std::uint64_t dropped_records() const {
+        return oversized.load(std::memory_order_relaxed);
+    }
+
+    void log(const std::string& message) const override {
+        // Level 'Off' in the dictionary marks raw text without a level prefix
+        static std::atomic<std::uint32_t> text_site{0};
+        log_fast(text_site, LogLevel::Off, "{}", message);
+    }
+
+    // Called through the BINLOG macro; 'site' is that call site's static id
+    template<typename... Args>
+    void log_fast(std::atomic<std::uint32_t>& site, LogLevel level,
+                  const char* format, const Args&... args) const {
+        std::uint32_t id = site.load(std::memory_order_acquire);
+        if (id == 0) {  // First call from this site - register its format once
+            id = binlog::FormatRegistry::instance().register_site(
+                site, level, format, binlog::signature_of<Args...>());
+        }
+
+        binlog::StagingBuffer& buffer = this_thread_buffer();
+        std::uint64_t now = std::max(binlog::read_timestamp(), buffer.last_timestamp);
+        std::uint64_t delta = now - buffer.last_timestamp;
+
+        std::size_t bytes = binlog::varint_size(id) + binlog::varint_size(delta)
+                          + (std::size_t{0} + ... + binlog::encoded_size(args));
+        if (bytes > buffer.capacity()) {  // Would never fit, however long we wait
+            oversized.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        binlog::RingCursor cursor = buffer.reserve(bytes);
+        cursor.put_varint(id);
+        cursor.put_varint(delta);
+        (binlog::encode(cursor, args), ...);
+
+        buffer.last_timestamp = now;
+        buffer.commit(cursor);
+    }
+
+private:
+    /*
+     * Each thread finds its buffer through a thread_local cache, so the
+     * mutex is only taken the first time a thread logs to this logger.
+     */
+    binlog::StagingBuffer& this_thread_buffer() const {
+        struct CachedBuffer {
+            std::uint64_t logger_id = 0;
+            std::shared_ptr<binlog::StagingBuffer> buffer;
+        };
+        thread_local CachedBuffer cached;
+
+        if (cached.logger_id != logger_id) {
+            cached.buffer = register_thread();
+            cached.logger_id = logger_id;
+        }
+        return *cached.buffer;
+    }
+
+    std::shared_ptr<binlog::StagingBuffer> register_thread() const {
+        std::lock_guard<std::mutex> lock(buffers_mutex);
+        auto me = std::this_thread::get_id();
+        for (const auto& buffer : buffers) {
+            if (buffer->owner == me) return buffer;  // Thread switched loggers and came back
+        }
+        buffers.push_back(std::make_shared<binlog::StagingBuffer>(
+            buffer_capacity, static_cast<std::uint32_t>(buffers.size()), me));
+        return buffers.back();
+    }
+
+    void write_header() {
+        // Measure how many nanoseconds one timestamp tick lasts (~10 ms, once)
+        double ns_per_tick = 1.0;
+#ifdef BINLOG_HAS_RDTSC
+        auto wall_start = std::chrono::steady_clock::now();
+        std::uint64_t tick_start = binlog::read_timestamp();
+        while (std::chrono::steady_clock::now() - wall_start < std::chrono::milliseconds(10)) {
+        }
+        double elapsed_ns = std::chrono::duration<double, std::nano>(
+            std::chrono::steady_clock::now() - wall_start).count();
+        ns_per_tick = elapsed_ns / static_cast<double>(binlog::read_timestamp() - tick_start);
+#endif
+        std::uint64_t start_tick = binlog::read_timestamp();
+        out.write("BINLOG01", 8);
+        out.write(reinterpret_cast<const char*>(&ns_per_tick), sizeof(ns_per_tick));
+        out.write(reinterpret_cast<const char*>(&start_tick), sizeof(start_tick));
+    }
+
+    static void append_varint(std::string& out, std::uint64_t value) {
+        while (value >= 0x80) {
+            out += static_cast<char>((value & 0x7F) | 0x80);
+            value >>= 7;
+        }
+        out += static_cast<char>(value);
+    }
+
+    // One pass over every thread buffer. Returns true if anything was written.
+    bool drain_once(std::string& batch) {
+        std::vector<std::shared_ptr<binlog::StagingBuffer>> snapshot;
+        {
+            std::lock_guard<std::mutex> lock(buffers_mutex);
+            snapshot = buffers;
+        }
+
+        // Read producer positions FIRST: any id used by those records was
+        // registered before they were published, so the dictionary read
+        // below is guaranteed to contain it
+        std::vector<std::size_t> ends;
+        ends.reserve(snapshot.size());
+        for (const auto& buffer : snapshot) ends.push_back(buffer->published());
+
+        for (const auto& entry : binlog::FormatRegistry::instance().entries_since(dictionary_written)) {
+            ++dictionary_written;
+            batch += 'D';
+            append_varint(batch, dictionary_written);
+            batch += static_cast<char>(entry.level);
+            append_varint(batch, entry.format.size());
+            batch += entry.format;
+            append_varint(batch, entry.signature.size());
+            batch += entry.signature;
+        }
+
+        bool wrote = false;
+        for (std::size_t i = 0; i < snapshot.size(); ++i) {
+            std::size_t pending = ends[i] - snapshot[i]->consumed();
+            if (pending == 0) continue;
+            batch += 'B';
+            append_varint(batch, snapshot[i]->thread_index);
+            append_varint(batch, pending);
+            snapshot[i]->drain_to(batch, ends[i]);
+            wrote = true;
+        }
+        return wrote;
+    }
+
+    void writer_loop() {
+        std::string batch;
+        for (;;) {
+            bool stop = stopping.load(std::memory_order_acquire);
+            bool wrote = drain_once(batch);
+            if (!batch.empty() && out) {
+                out.write(batch.data(), static_cast<std::streamsize>(batch.size()));
+            }
+            batch.clear();
+            if (stop) break;
+            if (!wrote) {
+                out.flush();
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+        out.flush();
+    }
+};
+
+/*
+ * BINLOG(logger, level, format, args...)
+ *
+ * A macro is needed so that each call site gets its OWN static id variable.
+ * Disabled levels cost one branch, exactly like logger.info(...).
+ */
+#define BINLOG(logger, level, ...)                                            \
+    do {                                                                      \
+        if ((logger).is_enabled(level)) {                                     \
+            static std::atomic<std::uint32_t> binlog_site_id{0};              \
+            (logger).log_fast(binlog_site_id, level, __VA_ARGS__);            \
+        }                                                                     \
+    } while (0)
+
+// =============================================================================
+// PART 6: Parallel Fan-Out Logging with Backpressure Policies
+// =============================================================================
+
+/*
+ * MultiLogger calls each destination one after another ON THE CALLER'S
+ * THREAD. If one destination is slow (a busy disk, a slow terminal), every
+ * other destination - and the application itself - waits for it.
+ *
+ * ParallelMultiLogger gives every destination ("sink") its own bounded
+ * queue and its own worker thread. log() only puts the message into the
+ * queues; the workers do the slow writing in parallel.
+ *
+ * What happens when a queue is full is chosen PER SINK:
+ *   Block       - the caller waits for room (nothing is ever lost)
+ *   DropNewest  - the new message is discarded
+ *   DropOldest  - the oldest queued message is discarded to make room
+ *   Sample      - while full, keep only every Nth new message (replacing
+ *                 the oldest) so a burst still leaves a representative trace
+ *
+ * Each sink is only ever called from its own worker thread, so even a
+ * destination that is not thread-safe (like ConsoleLogger) is safe here.
+ */
+enum class OverflowPolicy { Block, DropNewest, DropOldest, Sample };
+
+struct SinkStats {
+    std::uint64_t accepted = 0;  // Messages that entered the queue
+    std::uint64_t dropped = 0;   // Messages lost to the overflow policy
+    std::uint64_t written = 0;   // Messages handed to the destination
+};
+
+class ParallelMultiLogger : public Logger {
+private:
+    // One message is shared by every queue instead of being copied per sink
+    struct Record {
+        LogLevel level;
+        bool has_level;
+        std::shared_ptr<const std::string> message;
+    };
+
+    /*
+     * Sink - a destination plus its queue and worker
+     *
+     * The queue uses a mutex rather than the lock-free queue from PART 4
+     * because DropOldest lets PRODUCERS remove messages, which a
+     * single-consumer queue does not allow.
+     */
+    struct Sink {
+        Logger* logger;
+        OverflowPolicy policy;
+        size_t capacity;
+        size_t sample_every;
+
+        std::mutex mutex;
+        std::condition_variable not_empty;
+        std::condition_variable not_full;
+        std::condition_variable idle;
+        std::deque<Record> queue;
+        bool busy = false;
+        bool stopping = false;
+        std::uint64_t overflow_count = 0;  // Drives the Sample policy
+
+        std::atomic<std::uint64_t> accepted{0};
+        std::atomic<std::uint64_t> dropped{0};
+        std::atomic<std::uint64_t> written{0};
+
+        std::thread worker;
+    };
+
+    std::vector<std::unique_ptr<Sink>> sinks;
+
+public:
+    ParallelMultiLogger() { set_level(LogLevel::Off); }
+
+    // Drains every queue, then stops the workers
+    ~ParallelMultiLogger() override {
+        for (auto& sink : sinks) {
+            {
+                std::lock_guard<std::mutex> lock(sink->mutex);
+                sink->stopping = true;
+            }
+            sink->not_empty.notify_one();
+        }
+        for (auto& sink : sinks) {
+            sink->worker.join();
+        }
+    }
+
+    ParallelMultiLogger(const ParallelMultiLogger&) = delete;
+    ParallelMultiLogger& operator=(const ParallelMultiLogger&) = delete;
+
+    // Add all destinations BEFORE logging starts (this starts a thread).
+    // 'sample_every' is only used by OverflowPolicy::Sample.
+    void add_logger(Logger* logger, OverflowPolicy policy = OverflowPolicy::Block,
+                    size_t capacity = 1024, size_t sample_every = 10) {
+        auto sink = std::make_unique<Sink>();
+        sink->logger = logger;
+        sink->policy = policy;
+        sink->capacity = std::max<size_t>(capacity, 1);
+        sink->sample_every = std::max<size_t>(sample_every, 1);
+        sink->worker = std::thread(&ParallelMultiLogger::worker_loop, sink.get());
+        sinks.push_back(std::move(sink));
+        watch_level(logger);
+        watched_level_changed();
+    }
+
+    void log(const std::string& message) const override {
+        auto shared = std::make_shared<const std::string>(message);
+        for (const auto& sink : sinks) {
+            enqueue(*sink, Record{LogLevel::Info, false, shared});
+        }
+    }
+
+    void log_record(LogLevel level, const std::string& message) const override {
+        auto shared = std::make_shared<const std::string>(message);
+        for (const auto& sink : sinks) {
+            if (sink->logger->is_enabled(level)) {
+                enqueue(*sink, Record{level, true, shared});
+            }
+        }
+    }
+
+    // Counters for the destination added at position 'index'
+    SinkStats stats(size_t index) const {
+        const Sink& sink = *sinks.at(index);
+        SinkStats result;
+        result.accepted = sink.accepted.load(std::memory_order_relaxed);
+        result.dropped = sink.dropped.load(std::memory_order_relaxed);
+        result.written = sink.written.load(std::memory_order_relaxed);
+        return result;
+    }
+
+    size_t sink_count() const { return sinks.size(); }
+
+    // Wait until every queued message has been written
+    void flush() const {
+        for (const auto& sink : sinks) {
+            std::unique_lock<std::mutex> lock(sink->mutex);
+            sink->idle.wait(lock, [&] { return sink->queue.empty() && !sink->busy; });
+        }
+    }
+
+protected:
+    // Like MultiLogger: the lowest level any destination accepts
+    void watched_level_changed() override {
+        LogLevel lowest = LogLevel::Off;
+        for (const auto& sink : sinks) lowest = std::min(lowest, sink->logger->get_level());
+        set_level(lowest);
+    }
+
+private:
+    static void enqueue(Sink& sink, Record record) {
+        std::unique_lock<std::mutex> lock(sink.mutex);
+
+        if (sink.queue.size() >= sink.capacity) {
+            switch (sink.policy) {
+                case OverflowPolicy::Block:
+                    sink.not_full.wait(lock, [&] { return sink.queue.size() < sink.capacity; });
+                    break;
+                case OverflowPolicy::DropNewest:
+                    sink.dropped.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                case OverflowPolicy::DropOldest:
+                    sink.queue.pop_front();
+                    sink.dropped.fetch_add(1, std::memory_order_relaxed);
+                    break;
+                case OverflowPolicy::Sample:
+                    sink.dropped.fetch_add(1, std::memory_order_relaxed);
+                    if (++sink.overflow_count % sink.sample_every != 0) {
+                        return;  // Not this message's turn
+                    }
+                    sink.queue.pop_front();  // Make room for the sampled message
+                    break;
+            }
+        }
+
+        sink.queue.push_back(std::move(record));
+        sink.accepted.fetch_add(1, std::memory_order_relaxed);
+        lock.unlock();
+        sink.not_empty.notify_one();
+    }
+
+    static void worker_loop(Sink* sink) {
+        std::deque<Record> batch;
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(sink->mutex);
+                sink->not_empty.wait(lock, [&] { return !sink->queue.empty() || sink->stopping; });
+                if (sink->queue.empty()) break;  // Stopping and fully drained
+
+                // Take the whole queue at once so producers are blocked as
+                // briefly as possible while we do the slow writing
+                batch.swap(sink->queue);
+                sink->busy = true;
+            }
+            sink->not_full.notify_all();
+
+            for (const auto& record : batch) {
+                if (record.has_level) {
+                    sink->logger->log_record(record.level, *record.message);
+                } else {
+                    sink->logger->log(*record.message);
+                }
+            }
+            sink->written.fetch_add(batch.size(), std::memory_order_relaxed);
+            batch.clear();
+
+            {
+                std::lock_guard<std::mutex> lock(sink->mutex);
+                sink->busy = false;
+            }
+            sink->idle.notify_all();
+        }
+    }
+};
+
+// =============================================================================
+// PART 7: Data-Oriented Shapes (Structure of Arrays)
+// =============================================================================
+
+/*
+ * std::vector<Shape*> is flexible, but for MILLIONS of shapes it is slow:
+ * - every shape is a separate heap allocation (scattered in memory)
+ * - every area() call is an indirect (virtual) call the CPU must predict
+ * - the compiler cannot vectorize a loop of unknown function calls
+ *
+ * ShapeBatch stores each KIND of shape in its own columns instead:
+ *
+ *   circles:    radius[]
+ *   rectangles: width[]  height[]
+ *   triangles:  side_a[] side_b[] side_c[]
+ *
+ * Now "area of every circle" is a plain loop over one contiguous array of
+ * doubles - no calls, no branches. Compilers turn such loops into SIMD code
+ * that handles 2-8 shapes per instruction.
+ *
+ * TIP: build with -O3 -fno-math-errno (or -ffast-math) so the sqrt in
+ * Heron's formula can be vectorized too.
+ */
+namespace shape_kernels {
+
+// Each kernel is a simple counted loop over raw arrays - the shape the
+// auto-vectorizer recognizes best
+
+inline void circle_areas(const double* radius, double* out, size_t n) {
+    for (size_t i = 0; i < n; ++i) out[i] = M_PI * radius[i] * radius[i];
+}
+
+inline void circle_perimeters(const double* radius, double* out, size_t n) {
+    for (size_t i = 0; i < n; ++i) out[i] = 2.0 * M_PI * radius[i];
+}
+
+inline void rectangle_areas(const double* width, const double* height, double* out, size_t n) {
+    for (size_t i = 0; i < n; ++i) out[i] = width[i] * height[i];
+}
+
+inline void rectangle_perimeters(const double* width, const double* height, double* out, size_t n) {
+    for (size_t i = 0; i < n; ++i) out[i] = 2.0 * (width[i] + height[i]);
+}
+
+// Heron's formula; std::max keeps invalid (degenerate) triangles at area 0
+// instead of producing NaN, without a branch
+inline void triangle_areas(const double* a, const double* b, const double* c,
+                           double* out, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        double s = 0.5 * (a[i] + b[i] + c[i]);
+        double product = s * (s - a[i]) * (s - b[i]) * (s - c[i]);
+        out[i] = std::sqrt(std::max(product, 0.0));
+    }
+}
+
+inline void triangle_perimeters(const double* a, const double* b, const double* c,
+                                double* out, size_t n) {
+    for (size_t i = 0; i < n; ++i) out[i] = a[i] + b[i] + c[i];
+}
+
+/*
+ * Sums use four independent accumulators. A single 'total += x' makes
+ * every addition wait for the previous one; four running sums keep the
+ * CPU's floating-point units busy (and map onto SIMD lanes).
+ */
+template<typename Term>
+double sum_terms(size_t n, Term term) {
+    double acc0 = 0.0, acc1 = 0.0, acc2 = 0.0, acc3 = 0.0;
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        acc0 += term(i);
+        acc1 += term(i + 1);
+        acc2 += term(i + 2);
+        acc3 += term(i + 3);
+    }
+    for (; i < n; ++i) acc0 += term(i);
+    return (acc0 + acc1) + (acc2 + acc3);
+}
+
+}  // namespace shape_kernels
+
+class ShapeBatch {
+public:
+    struct KindTotals {
+        size_t count = 0;
+        double area = 0.0;
+        double perimeter = 0.0;
+    };
+
+    struct Totals {
+        KindTotals circles;
+        KindTotals rectangles;
+        KindTotals triangles;
+
+        double area() const { return circles.area + rectangles.area + triangles.area; }
+        double perimeter() const {
+            return circles.perimeter + rectangles.perimeter + triangles.perimeter;
+        }
+    };
+
+private:
+    std::vector<double> circle_radius;
+    std::vector<double> rect_width, rect_height;
+    std::vector<double> tri_a, tri_b, tri_c;
+
+public:
+    void reserve(size_t circles, size_t rectangles, size_t triangles) {
+        circle_radius.reserve(circles);
+        rect_width.reserve(rectangles);
+        rect_height.reserve(rectangles);
+        tri_a.reserve(triangles);
+        tri_b.reserve(triangles);
+        tri_c.reserve(triangles);
+    }
+
+    void add_circle(double radius) {
+        circle_radius.push_back(radius);
+    }
+
+    void add_rectangle(double width, double height) {
+        rect_width.push_back(width);
+        rect_height.push_back(height);
+    }
+
+    void add_triangle(double a, double b, double c) {
+        tri_a.push_back(a);
+        tri_b.push_back(b);
+        tri_c.push_back(c);
+    }
+
+    size_t circle_count() const { return circle_radius.size(); }
+    size_t rectangle_count() const { return rect_width.size(); }
+    size_t triangle_count() const { return tri_a.size(); }
+    size_t size() const { return circle_count() + rectangle_count() + triangle_count(); }
+
+    /*
+     * Per-shape results. 'out' is laid out kind by kind:
+     *   [all circles][all rectangles][all triangles]
+     * each kind in the order its shapes were added.
+     */
+    void areas(std::vector<double>& out) const {
+        out.resize(size());
+        double* dest = out.data();
+        shape_kernels::circle_areas(circle_radius.data(), dest, circle_count());
+        dest += circle_count();
+        shape_kernels::rectangle_areas(rect_width.data(), rect_height.data(), dest, rectangle_count());
+        dest += rectangle_count();
+        shape_kernels::triangle_areas(tri_a.data(), tri_b.data(), tri_c.data(), dest, triangle_count());
+    }
+
+    void perimeters(std::vector<double>& out) const {
+        out.resize(size());
+        double* dest = out.data();
+        shape_kernels::circle_perimeters(circle_radius.data(), dest, circle_count());
+        dest += circle_count();
+        shape_kernels::rectangle_perimeters(rect_width.data(), rect_height.data(), dest, rectangle_count());
+        dest += rectangle_count();
+        shape_kernels::triangle_perimeters(tri_a.data(), tri_b.data(), tri_c.data(), dest, triangle_count());
+    }
+
+    // Totals are computed directly from the columns - no temporary arrays
+    Totals totals() const {
+        const double* r = circle_radius.data();
+        const double* w = rect_width.data();
+        const double* h = rect_height.data();
+        const double* a = tri_a.data();
+        const double* b = tri_b.data();
+        const double* c = tri_c.data();
+
+        Totals result;
+        result.circles.count = circle_count();
+        // Sum of pi*r^2 = pi * (sum of r^2): one multiply by pi at the end
+        result.circles.area = M_PI * shape_kernels::sum_terms(
+            circle_count(), [r](size_t i) { return r[i] * r[i]; });
+        result.circles.perimeter = 2.0 * M_PI * shape_kernels::sum_terms(
+            circle_count(), [r](size_t i) { return r[i]; });
+
+        result.rectangles.count = rectangle_count();
+        result.rectangles.area = shape_kernels::sum_terms(
+            rectangle_count(), [w, h](size_t i) { return w[i] * h[i]; });
+        result.rectangles.perimeter = 2.0 * shape_kernels::sum_terms(
+            rectangle_count(), [w, h](size_t i) { return w[i] + h[i]; });
+
+        result.triangles.count = triangle_count();
+        result.triangles.area = shape_kernels::sum_terms(
+            triangle_count(), [a, b, c](size_t i) {
+                double s = 0.5 * (a[i] + b[i] + c[i]);
+                return std::sqrt(std::max(s * (s - a[i]) * (s - b[i]) * (s - c[i]), 0.0));
+            });
+        result.triangles.perimeter = shape_kernels::sum_terms(
+            triangle_count(), [a, b, c](size_t i) { return a[i] + b[i] + c[i]; });
+        return result;
+    }
+};
+
+// =============================================================================
+// PART 8: Closed-Set Static Polymorphism (std::variant + CRTP)
+// =============================================================================
+
+/*
+ * Virtual functions are the right tool when NEW shape types can appear at
+ * runtime (plugins, user extensions). When the full set of shapes is known
+ * at compile time, we can get polymorphism without vtables:
+ *
+ * 1. CRTP ("Curiously Recurring Template Pattern")
+ *      class Circle : public ShapeInterface<Circle>
+ *    The base class knows the derived type at compile time, so it can call
+ *    derived functions through static_cast - no virtual call needed.
+ *
+ * 2. std::variant<Circle, Rectangle, Triangle>
+ *    A value that holds exactly ONE of the listed types. Shapes are stored
+ *    BY VALUE inside one contiguous vector: no 'new', no pointer chasing.
+ *    std::visit picks the right code with a small switch, and the compiler
+ *    can inline area() for each case.
+ *
+ * Trade-off: adding a new shape means recompiling with a longer type list.
+ */
+namespace static_shapes {
+
+// Shared behaviour for every shape kind, resolved at compile time
+template<typename Derived>
+class ShapeInterface {
+public:
+    void display_info() const {
+        const Derived& self = static_cast<const Derived&>(*this);
+        std::cout << self.get_name() << ": "
+                  << "Area = " << self.area()
+                  << ", Perimeter = " << self.perimeter() << "\n";
+    }
+
+protected:
+    // Not virtual: these objects are never deleted through the base class
+    ~ShapeInterface() = default;
+};
+
+class Circle : public ShapeInterface<Circle> {
+private:
+    double radius;
+
+public:
+    explicit Circle(double r) : radius(r) {}
+
+    double area() const { return M_PI * radius * radius; }
+    double perimeter() const { return 2 * M_PI * radius; }
+    static const char* get_name() { return "Circle"; }
+};
+
+class Rectangle : public ShapeInterface<Rectangle> {
+private:
+    double width;
+    double height;
+
+public:
+    Rectangle(double w, double h) : width(w), height(h) {}
+
+    double area() const { return width * height; }
+    double perimeter() const { return 2 * (width + height); }
+    static const char* get_name() { return "Rectangle"; }
+};
+
+class Triangle : public ShapeInterface<Triangle> {
+private:
+    double side_a, side_b, side_c;
+
+public:
+    Triangle(double a, double b, double c) : side_a(a), side_b(b), side_c(c) {}
+
+    double area() const {
+        // Using Heron's formula
+        double s = perimeter() / 2.0;
+        return std::sqrt(s * (s - side_a) * (s - side_b) * (s - side_c));
+    }
+
+    double perimeter() const { return side_a + side_b + side_c; }
+    static const char* get_name() { return "Triangle"; }
+};
+
+/*
+ * EXTENSION POINT: what a type needs to be a shape kind
+ *
+ * Any class with area(), perimeter() and get_name() works - inherit from
+ * ShapeInterface<YourShape> to get display_info() for free, then list it:
+ *
+ *   using MyShapes = ShapeCollection<Circle, Rectangle, Triangle, YourShape>;
+ *
+ * is_shape_kind turns a missing function into one readable error message
+ * instead of pages of template errors.
+ */
+template<typename T, typename = void>
+struct is_shape_kind : std::false_type {};
+
+template<typename T>
+struct is_shape_kind<T, std::void_t<decltype(std::declval<const T&>().area()),
+                                    decltype(std::declval<const T&>().perimeter()),
+                                    decltype(std::declval<const T&>().get_name())>>
+    : std::true_type {};
+
+template<typename... Kinds>
+class ShapeCollection {
+    static_assert((is_shape_kind<Kinds>::value && ...),
+                  "Every shape kind needs area(), perimeter() and get_name()");
+
+public:
+    using value_type = std::variant<Kinds...>;
+
+private:
+    std::vector<value_type> shapes;  // Shapes stored by value, back to back
+
+public:
+    void reserve(size_t count) { shapes.reserve(count); }
+    size_t size() const { return shapes.size(); }
+
+    // Construct a shape of kind 'Kind' directly inside the vector
+    template<typename Kind, typename... Args>
+    Kind& emplace(Args&&... args) {
+        value_type& slot = shapes.emplace_back(std::in_place_type<Kind>,
+                                               std::forward<Args>(args)...);
+        return std::get<Kind>(slot);
+    }
+
+    // Calls visitor(shape) with the concrete type of every shape
+    template<typename Visitor>
+    void visit_all(Visitor&& visitor) const {
+        for (const auto& shape : shapes) {
+            std::visit(visitor, shape);
+        }
+    }
+
+    // Calls f(area) for every shape
+    template<typename Func>
+    void for_each_area(Func&& f) const {
+        visit_all([&f](const auto& shape) { f(shape.area()); });
+    }
+
+    template<typename Func>
+    void for_each_perimeter(Func&& f) const {
+        visit_all([&f](const auto& shape) { f(shape.perimeter()); });
+    }
+
+    void display_info() const {
+        visit_all([](const auto& shape) { shape.display_info(); });
+    }
+
+    double total_area() const {
+        double total = 0.0;
+        for_each_area([&total](double area) { total += area; });
+        return total;
+    }
+};
+
+using BasicShapes = ShapeCollection<Circle, Rectangle, Triangle>;
+
+}  // namespace static_shapes
+
 // =============================================================================
 // Demonstration Functions
 // =============================================================================
@@ -434,6 +1851,397 @@ void demo_logger_system() {
     std::cout << "\nCheck 'application.log' file for file logger output!\n";
 }
 
+void demo_async_file_logger() {
+    std::cout << "\n=== DEMO 4: Asynchronous File Logger ===\n\n";
+
+    // Same Application code, different Logger - no changes needed
+    {
+        AsyncFileLogger async_logger("application_async.log");
+        Application app("AsyncProcess", &async_logger);
+        app.run();
+    }  // Destructor drains the queue and flushes the file
+    std::cout << "Application log written to 'application_async.log'\n\n";
+
+    // Compare the cost per message of both file loggers
+    const int message_count = 20000;
+    using clock = std::chrono::steady_clock;
+
+    auto start = clock::now();
+    {
+        FileLogger file_logger("bench_file.log");
+        for (int i = 0; i < message_count; ++i) {
+            file_logger.log("Benchmark message " + std::to_string(i));
+        }
+    }
+    auto file_time = clock::now() - start;
+
+    start = clock::now();
+    {
+        AsyncFileLogger async_logger("bench_async.log");
+        for (int i = 0; i < message_count; ++i) {
+            async_logger.log("Benchmark message " + std::to_string(i));
+        }
+    }  // Includes the final flush, so the comparison is fair
+    auto async_time = clock::now() - start;
+
+    auto to_ms = [](clock::duration d) {
+        return std::chrono::duration<double, std::milli>(d).count();
+    };
+    std::cout << message_count << " messages:\n";
+    std::cout << "  FileLogger (open/write/close per line): " << to_ms(file_time) << " ms\n";
+    std::cout << "  AsyncFileLogger (batched, file kept open): " << to_ms(async_time) << " ms\n";
+}
+
+void demo_lazy_logging() {
+    std::cout << "\n=== DEMO 5: Level Filtering and Lazy Formatting ===\n\n";
+
+    // Only warnings and errors reach this console logger
+    ConsoleLogger console_logger;
+    console_logger.set_level(LogLevel::Warning);
+
+    std::cout << "--- Console Logger at level Warning ---\n";
+    Application app("FilteredProcess", &console_logger);
+    app.run();
+
+    // Mix levels: console shows everything, file only errors
+    ConsoleLogger verbose_console;
+    FileLogger error_file("errors_only.log");
+    error_file.set_level(LogLevel::Error);
+
+    MultiLogger multi_logger;
+    multi_logger.add_logger(&verbose_console);
+    multi_logger.add_logger(&error_file);
+
+    std::cout << "\n--- Multi Logger: console=Info, file=Error ---\n";
+    multi_logger.info("Formatted once, written only where accepted: ", 42, " items");
+    multi_logger.error("Disk usage at ", 97.5, "%");
+    std::cout << "(Only the ERROR line went to 'errors_only.log')\n";
+
+    // The MultiLogger asks its destinations on every call, so a level
+    // changed after add_logger() counts immediately
+    verbose_console.set_level(LogLevel::Error);
+    multi_logger.info("Not shown: no destination accepts Info any more");
+    std::cout << "(After raising the console to Error, the Info line was skipped)\n";
+
+    // Cost of a disabled log call: eager '+' vs. lazy arguments. The calls
+    // go through a volatile pointer, so the compiler cannot see that the
+    // logger is always disabled and remove the loops (a real call site
+    // does not know the level at compile time either).
+    SilentLogger silent_logger;
+    const Logger* volatile silent_pointer = &silent_logger;
+    const std::string task_name = "A task name long enough to need the heap";
+    const int calls = 1000000;
+    using clock = std::chrono::steady_clock;
+
+    auto start = clock::now();
+    for (int i = 0; i < calls; ++i) {
+        silent_pointer->log_info("Starting task: " + task_name);  // Builds a string every time
+    }
+    auto eager_time = clock::now() - start;
+
+    start = clock::now();
+    for (int i = 0; i < calls; ++i) {
+        silent_pointer->info("Starting task: ", task_name);  // One branch, nothing built
+    }
+    auto lazy_time = clock::now() - start;
+
+    auto to_ms = [](clock::duration d) {
+        return std::chrono::duration<double, std::milli>(d).count();
+    };
+    std::cout << "\n" << calls << " disabled log calls:\n";
+    std::cout << "  log_info(\"...\" + name): " << to_ms(eager_time) << " ms\n";
+    std::cout << "  info(\"...\", name):      " << to_ms(lazy_time) << " ms\n";
+}
+
+void demo_binary_logger() {
+    std::cout << "\n=== DEMO 6: Binary Logger with Deferred Formatting ===\n\n";
+
+    const int records = 200000;
+    using clock = std::chrono::steady_clock;
+
+    // Text version: every record is formatted into a line on this thread
+    auto start = clock::now();
+    {
+        AsyncFileLogger text_logger("requests_text.log");
+        for (int i = 0; i < records; ++i) {
+            text_logger.info("Processed request ", i, " from user ", i % 977,
+                             " in ", 20 + i % 50, " us");
+        }
+    }
+    auto text_time = clock::now() - start;
+
+    // Binary version: only the id, a timestamp and three small numbers
+    start = clock::now();
+    clock::duration call_time{};
+    {
+        BinaryLogger binary_logger("requests.binlog");
+        auto calls_start = clock::now();
+        for (int i = 0; i < records; ++i) {
+            BINLOG(binary_logger, LogLevel::Info, "Processed request {} from user {} in {} us",
+                   i, i % 977, 20 + i % 50);
+        }
+        call_time = clock::now() - calls_start;
+
+        Application app("BinaryProcess", &binary_logger);  // Still a Logger!
+        app.run();
+    }
+    auto binary_time = clock::now() - start;
+
+    auto file_size = [](const char* name) {
+        std::ifstream in(name, std::ios::binary | std::ios::ate);
+        return in ? static_cast<long long>(in.tellg()) : 0LL;
+    };
+    auto to_ms = [](clock::duration d) {
+        return std::chrono::duration<double, std::milli>(d).count();
+    };
+
+    long long text_bytes = file_size("requests_text.log");
+    long long binary_bytes = file_size("requests.binlog");
+    std::cout << records << " records:\n";
+    std::cout << "  Text (AsyncFileLogger):  " << to_ms(text_time) << " ms, "
+              << text_bytes << " bytes\n";
+    std::cout << "  Binary (BinaryLogger):   " << to_ms(binary_time) << " ms, "
+              << binary_bytes << " bytes\n";
+    std::cout << "  Binary cost per call:    "
+              << std::chrono::duration<double, std::nano>(call_time).count() / records
+              << " ns\n";
+    if (binary_bytes > 0) {
+        std::cout << "  Size ratio (text/binary): "
+                  << static_cast<double>(text_bytes) / static_cast<double>(binary_bytes) << "x\n";
+    }
+    std::cout << "Decode with: ./binary_log_decoder requests.binlog\n";
+}
+
+/*
+ * Demo helpers: a deliberately slow destination (think: overloaded disk)
+ * and a fast one that only counts what it receives
+ */
+class SlowLogger : public Logger {
+public:
+    void log(const std::string& /* message */) const override {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+};
+
+class CountingLogger : public Logger {
+private:
+    mutable std::atomic<int> count{0};
+
+public:
+    void log(const std::string& /* message */) const override {
+        count.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    int get_count() const { return count.load(); }
+};
+
+void demo_parallel_multi_logger() {
+    std::cout << "\n=== DEMO 7: Parallel Fan-Out with Backpressure ===\n\n";
+
+    const int messages = 300;
+    using clock = std::chrono::steady_clock;
+    auto to_ms = [](clock::duration d) {
+        return std::chrono::duration<double, std::milli>(d).count();
+    };
+
+    // Sequential MultiLogger: the slow destination holds up everything
+    SlowLogger slow_sequential;
+    CountingLogger fast_sequential;
+    MultiLogger sequential;
+    sequential.add_logger(&slow_sequential);
+    sequential.add_logger(&fast_sequential);
+
+    auto start = clock::now();
+    for (int i = 0; i < messages; ++i) {
+        sequential.info("Event ", i);
+    }
+    std::cout << "MultiLogger:         caller spent " << to_ms(clock::now() - start)
+              << " ms logging " << messages << " messages\n";
+
+    // Parallel version: slow sink drops its oldest messages, fast sink
+    // blocks (so it never loses anything)
+    SlowLogger slow_parallel;
+    CountingLogger fast_parallel;
+    ParallelMultiLogger parallel;
+    parallel.add_logger(&slow_parallel, OverflowPolicy::DropOldest, 32);
+    parallel.add_logger(&fast_parallel, OverflowPolicy::Block, 1024);
+
+    start = clock::now();
+    for (int i = 0; i < messages; ++i) {
+        parallel.info("Event ", i);
+    }
+    std::cout << "ParallelMultiLogger: caller spent " << to_ms(clock::now() - start)
+              << " ms logging " << messages << " messages\n";
+
+    parallel.flush();
+    const char* names[] = {"slow sink (DropOldest, 32)", "fast sink (Block, 1024)"};
+    for (size_t i = 0; i < parallel.sink_count(); ++i) {
+        SinkStats stats = parallel.stats(i);
+        std::cout << "  " << names[i] << ": accepted=" << stats.accepted
+                  << " dropped=" << stats.dropped << " written=" << stats.written << "\n";
+    }
+    std::cout << "  fast sink received " << fast_parallel.get_count() << " messages\n";
+}
+
+void demo_shape_batch() {
+    std::cout << "\n=== DEMO 8: Data-Oriented ShapeBatch vs. Virtual Calls ===\n\n";
+
+    const size_t shape_count = 3000000;
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> size_dist(1.0, 10.0);
+    std::uniform_int_distribution<int> kind_dist(0, 2);
+
+    // Build the SAME random shapes in both representations
+    std::vector<std::unique_ptr<Shape>> objects;
+    objects.reserve(shape_count);
+    ShapeBatch batch;
+    batch.reserve(shape_count / 3 + 1, shape_count / 3 + 1, shape_count / 3 + 1);
+
+    for (size_t i = 0; i < shape_count; ++i) {
+        switch (kind_dist(rng)) {
+            case 0: {
+                double r = size_dist(rng);
+                objects.push_back(std::make_unique<Circle>(r));
+                batch.add_circle(r);
+                break;
+            }
+            case 1: {
+                double w = size_dist(rng), h = size_dist(rng);
+                objects.push_back(std::make_unique<Rectangle>(w, h));
+                batch.add_rectangle(w, h);
+                break;
+            }
+            default: {
+                // Pick c between |a-b| and a+b so the triangle is valid
+                double a = size_dist(rng), b = size_dist(rng);
+                double c = std::abs(a - b) + (a + b - std::abs(a - b)) * 0.5;
+                objects.push_back(std::make_unique<Triangle>(a, b, c));
+                batch.add_triangle(a, b, c);
+                break;
+            }
+        }
+    }
+
+    using clock = std::chrono::steady_clock;
+    auto to_ms = [](clock::duration d) {
+        return std::chrono::duration<double, std::milli>(d).count();
+    };
+
+    auto start = clock::now();
+    double virtual_area = 0.0, virtual_perimeter = 0.0;
+    for (const auto& shape : objects) {
+        virtual_area += shape->area();            // One virtual call each
+        virtual_perimeter += shape->perimeter();
+    }
+    auto virtual_time = clock::now() - start;
+
+    start = clock::now();
+    ShapeBatch::Totals totals = batch.totals();
+    auto batch_time = clock::now() - start;
+
+    std::vector<double> areas;
+    start = clock::now();
+    batch.areas(areas);
+    auto areas_time = clock::now() - start;
+
+    std::cout << shape_count << " shapes (" << batch.circle_count() << " circles, "
+              << batch.rectangle_count() << " rectangles, "
+              << batch.triangle_count() << " triangles)\n";
+    std::cout << "  vector<unique_ptr<Shape>> totals: " << to_ms(virtual_time) << " ms\n";
+    std::cout << "  ShapeBatch::totals():             " << to_ms(batch_time) << " ms\n";
+    std::cout << "  ShapeBatch::areas() per shape:    " << to_ms(areas_time) << " ms\n";
+    std::cout << "  Total area:      virtual=" << virtual_area
+              << " batch=" << totals.area() << "\n";
+    std::cout << "  Total perimeter: virtual=" << virtual_perimeter
+              << " batch=" << totals.perimeter() << "\n";
+    std::cout << "  Per kind area:   circles=" << totals.circles.area
+              << " rectangles=" << totals.rectangles.area
+              << " triangles=" << totals.triangles.area << "\n";
+}
+
+namespace static_shapes {
+
+// Extension example: a new kind needs no changes to existing code
+class Square : public ShapeInterface<Square> {
+private:
+    double side;
+
+public:
+    explicit Square(double s) : side(s) {}
+
+    double area() const { return side * side; }
+    double perimeter() const { return 4 * side; }
+    static const char* get_name() { return "Square"; }
+};
+
+}  // namespace static_shapes
+
+void demo_static_polymorphism() {
+    std::cout << "\n=== DEMO 9: Static Polymorphism with std::variant and CRTP ===\n\n";
+
+    // Same shapes as DEMO 2, stored by value - no new/delete anywhere
+    static_shapes::ShapeCollection<static_shapes::Circle, static_shapes::Rectangle,
+                                   static_shapes::Triangle, static_shapes::Square> shapes;
+    shapes.emplace<static_shapes::Circle>(5.0);
+    shapes.emplace<static_shapes::Rectangle>(4.0, 6.0);
+    shapes.emplace<static_shapes::Triangle>(3.0, 4.0, 5.0);
+    shapes.emplace<static_shapes::Circle>(10.0);
+    shapes.emplace<static_shapes::Square>(3.0);  // The extension kind
+
+    std::cout << "Shape information:\n";
+    shapes.display_info();
+    std::cout << "\nTotal area of all shapes: " << shapes.total_area() << "\n";
+
+    // Bulk comparison against virtual dispatch
+    const size_t shape_count = 3000000;
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> size_dist(1.0, 10.0);
+    std::uniform_int_distribution<int> kind_dist(0, 2);
+
+    std::vector<std::unique_ptr<Shape>> objects;
+    objects.reserve(shape_count);
+    static_shapes::BasicShapes values;
+    values.reserve(shape_count);
+
+    for (size_t i = 0; i < shape_count; ++i) {
+        double a = size_dist(rng), b = size_dist(rng);
+        switch (kind_dist(rng)) {
+            case 0:
+                objects.push_back(std::make_unique<Circle>(a));
+                values.emplace<static_shapes::Circle>(a);
+                break;
+            case 1:
+                objects.push_back(std::make_unique<Rectangle>(a, b));
+                values.emplace<static_shapes::Rectangle>(a, b);
+                break;
+            default:  // Sides a, b, max(a, b) always form a valid triangle
+                objects.push_back(std::make_unique<Triangle>(a, b, std::max(a, b)));
+                values.emplace<static_shapes::Triangle>(a, b, std::max(a, b));
+                break;
+        }
+    }
+
+    using clock = std::chrono::steady_clock;
+    auto to_ms = [](clock::duration d) {
+        return std::chrono::duration<double, std::milli>(d).count();
+    };
+
+    auto start = clock::now();
+    double virtual_total = 0.0;
+    for (const auto& shape : objects) virtual_total += shape->area();
+    auto virtual_time = clock::now() - start;
+
+    start = clock::now();
+    double variant_total = values.total_area();
+    auto variant_time = clock::now() - start;
+
+    std::cout << "\n" << shape_count << " shapes, total area:\n";
+    std::cout << "  vector<unique_ptr<Shape>>: " << to_ms(virtual_time) << " ms ("
+              << virtual_total << ")\n";
+    std::cout << "  ShapeCollection (variant): " << to_ms(variant_time) << " ms ("
+              << variant_total << ")\n";
+}
+
 // =============================================================================
 // Main Function
 // =============================================================================
@@ -449,6 +2257,12 @@ int main() {
     demo_basic_polymorphism();
     demo_abstract_classes();
     demo_logger_system();
+    demo_async_file_logger();
+    demo_lazy_logging();
+    demo_binary_logger();
+    demo_parallel_multi_logger();
+    demo_shape_batch();
+    demo_static_polymorphism();
 
     std::cout << "\n" << std::string(60, '=') << "\n";
     std::cout << "Demo complete! Review the code comments for explanations.\n";
@@ -536,16 +2350,39 @@ PROBLEM SET 3: Advanced Logging System
 - See demo_logger_system() function
 - Logger hierarchy and Application class demonstrate Problems 3.1-3.3
 
+BEYOND THE ASSIGNMENT: Performance-Minded Extensions
+- See demo_async_file_logger() function
+- AsyncFileLogger keeps the file open and batches writes on a background thread
+- See demo_lazy_logging() function
+- LogLevel filtering plus info()/warning()/error() format only accepted messages
+- See demo_binary_logger() function
+- BinaryLogger + BINLOG store format ids and raw arguments; decode the file
+  with binary_log_decoder.cpp
+- See demo_parallel_multi_logger() function
+- ParallelMultiLogger gives each destination its own queue, thread and
+  overflow policy (Block, DropNewest, DropOldest, Sample)
+- See demo_shape_batch() function
+- ShapeBatch stores each shape kind in its own arrays (structure of arrays)
+  so area/perimeter loops vectorize instead of making virtual calls
+- See demo_static_polymorphism() function
+- static_shapes::ShapeCollection stores a closed set of shapes by value in
+  a std::variant vector; CRTP supplies display_info() without vtables
+
 ╔═══════════════════════════════════════════════════════════════════════════╗
 ║                      HOW TO USE THIS FILE                                 ║
 ╚═══════════════════════════════════════════════════════════════════════════╝
 
 COMPILATION:
-    g++ -std=c++17 -Wall -Wextra polymorphism_hints.cpp -o polymorphism_demo
+    g++ -std=c++17 -Wall -Wextra -pthread polymorphism_hints.cpp -o polymorphism_demo
 
     or
 
-    clang++ -std=c++17 -Wall -Wextra polymorphism_hints.cpp -o polymorphism_demo
+    clang++ -std=c++17 -Wall -Wextra -pthread polymorphism_hints.cpp -o polymorphism_demo
+
+    (-pthread is needed because AsyncFileLogger uses a background thread)
+
+    For meaningful benchmark numbers (DEMO 8) add optimization:
+    g++ -std=c++17 -O3 -fno-math-errno -pthread polymorphism_hints.cpp -o polymorphism_demo
 
 EXECUTION:
     ./polymorphism_demo
@@ -553,6 +2390,8 @@ EXECUTION:
 EXPECTED OUTPUT:
     - Console output showing polymorphic behavior
     - File 'application.log' created with log messages
+    - File 'application_async.log' written by the AsyncFileLogger
+    - File 'requests.binlog' - binary log, see binary_log_decoder.cpp
 
 WHEN YOU'RE STUCK:
     1. Read the comments for the relevant section
@@ -1,6 +1,30 @@
 #include <iostream>
 #include <string>
+#include <algorithm>
 #include <cmath>
+#include <charconv>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <initializer_list>
+#include <map>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#if __cplusplus >= 202002L
+#include <span>
+#endif
 
 // =============================================================================
 // PROBLEM SET 1: FUNCTION TEMPLATE FUNDAMENTALS
@@ -95,13 +119,168 @@ public:
     }
 };
 
+// Span: a non-owning view of contiguous elements (pointer + length)
+// -----------------------------------------------------------------------------
+// A function that takes Span<const double> works with ANY contiguous storage:
+// built-in arrays, heap arrays, fixed arrays... without templates per container.
+// C++20 has std::span; for C++17 we provide a small equivalent with the same
+// interface, so code written against Span works with either standard.
+
+#if __cplusplus >= 202002L
+template<typename T>
+using Span = std::span<T>;
+#else
+template<typename T>
+class Span {
+private:
+    T* ptr;
+    size_t length;
+
+public:
+    constexpr Span() : ptr(nullptr), length(0) {}
+    constexpr Span(T* first, size_t count) : ptr(first), length(count) {}
+
+    template<size_t N>
+    constexpr Span(T (&array)[N]) : ptr(array), length(N) {}
+
+    // Allows Span<int> -> Span<const int> (but not the other way around)
+    template<typename U, typename = std::enable_if_t<std::is_convertible<U (*)[], T (*)[]>::value>>
+    constexpr Span(const Span<U>& other) : ptr(other.data()), length(other.size()) {}
+
+    constexpr T* data() const { return ptr; }
+    constexpr size_t size() const { return length; }
+    constexpr bool empty() const { return length == 0; }
+    constexpr T& operator[](size_t index) const { return ptr[index]; }
+    constexpr T* begin() const { return ptr; }
+    constexpr T* end() const { return ptr + length; }
+
+    constexpr Span subspan(size_t offset, size_t count) const {
+        return Span(ptr + offset, count);
+    }
+};
+#endif
+
+// Marks "size chosen at runtime" (same idea as C++20's std::dynamic_extent)
+constexpr size_t dynamic_extent = static_cast<size_t>(-1);
+
+// BufferedWriter: fast text output for large amounts of data
+// -----------------------------------------------------------------------------
+// std::cout << value formats and hands over ONE element at a time (and
+// std::endl also flushes every line). For millions of elements that overhead
+// dominates. BufferedWriter instead:
+// - formats numbers with std::to_chars (no locale, no stream state)
+// - collects text in one large reusable buffer
+// - hands the buffer to the C stream in big chunks
+//
+// It writes to a C FILE* (stdout by default). std::cout is synchronized with
+// stdout, so output from both stays in order as long as flush() is called
+// before switching back to std::cout (the destructor also flushes).
+
+class BufferedWriter {
+private:
+    // write_value() formats a number in place and needs up to 32 bytes of
+    // free space, so smaller buffers are rounded up to this
+    static constexpr size_t min_buffer_size = 64;
+
+    std::FILE* stream;
+    std::unique_ptr<char[]> buffer;
+    size_t capacity;
+    size_t used = 0;
+
+    // Make room for 'bytes' more characters
+    void reserve(size_t bytes) {
+        if (capacity - used < bytes) flush();
+    }
+
+public:
+    explicit BufferedWriter(std::FILE* out = stdout, size_t buffer_size = 1 << 16)
+        : stream(out),
+          buffer(std::make_unique<char[]>(std::max(buffer_size, min_buffer_size))),
+          capacity(std::max(buffer_size, min_buffer_size)) {}
+
+    ~BufferedWriter() { flush(); }
+
+    BufferedWriter(const BufferedWriter&) = delete;
+    BufferedWriter& operator=(const BufferedWriter&) = delete;
+
+    void flush() {
+        if (used > 0) {
+            std::fwrite(buffer.get(), 1, used, stream);
+            used = 0;
+        }
+    }
+
+    void put(char c) {
+        reserve(1);
+        buffer[used++] = c;
+    }
+
+    void write(std::string_view text) {
+        if (text.size() > capacity) {  // Too big to buffer - write it directly
+            flush();
+            std::fwrite(text.data(), 1, text.size(), stream);
+            return;
+        }
+        reserve(text.size());
+        std::memcpy(buffer.get() + used, text.data(), text.size());
+        used += text.size();
+    }
+
+    // Writes any value: numbers through to_chars, strings directly, and
+    // everything else through its operator<< (slower, but still correct)
+    template<typename T>
+    void write_value(const T& value) {
+        if constexpr (std::is_same<T, bool>::value) {
+            write(value ? "1" : "0");  // Same as std::cout without boolalpha
+        } else if constexpr (std::is_same<T, char>::value || std::is_same<T, signed char>::value ||
+                             std::is_same<T, unsigned char>::value) {
+            put(static_cast<char>(value));  // std::cout prints all three as characters
+        } else if constexpr (std::is_integral<T>::value) {
+            reserve(24);  // Enough for any 64-bit integer
+            auto result = std::to_chars(buffer.get() + used, buffer.get() + capacity, value);
+            used = static_cast<size_t>(result.ptr - buffer.get());
+        } else if constexpr (std::is_floating_point<T>::value) {
+            // 'general' with precision 6 matches std::cout's default output
+            reserve(32);
+            auto result = std::to_chars(buffer.get() + used, buffer.get() + capacity, value,
+                                        std::chars_format::general, 6);
+            used = static_cast<size_t>(result.ptr - buffer.get());
+        } else if constexpr (std::is_convertible<const T&, std::string_view>::value) {
+            write(std::string_view(value));
+        } else {
+            std::ostringstream formatted;
+            formatted << value;
+            write(formatted.str());
+        }
+    }
+
+    // Writes "[a, b, c]" for a whole range in one call
+    template<typename T>
+    void write_list(Span<const T> values) {
+        put('[');
+        for (size_t i = 0; i < values.size(); ++i) {
+            if (i > 0) write(", ");
+            write_value(values[i]);
+        }
+        put(']');
+    }
+};
+
 // Problem 2.2: Template Container with Dynamic Storage
 // -----------------------------------------------------------------------------
 // A template class that manages a dynamic array of any type.
 // This demonstrates memory management with templates.
+//
+// SimpleArray<T> (size chosen at runtime, heap storage) and SimpleArray<T, N>
+// (size fixed at compile time, no heap) share one name: the second template
+// parameter defaults to dynamic_extent, and each case gets its own definition.
+
+template<typename T, size_t N = dynamic_extent>
+class SimpleArray;
 
+// Runtime-sized version: partial specialization for N == dynamic_extent
 template<typename T>
-class SimpleArray {
+class SimpleArray<T, dynamic_extent> {
 private:
     T* data;              // Pointer to dynamically allocated array
     size_t array_size;    // Size of the array
@@ -142,6 +321,10 @@ public:
         return array_size;
     }
 
+    // Views over the elements, for kernels that accept any contiguous storage
+    Span<T> as_span() { return Span<T>(data, array_size); }
+    Span<const T> as_span() const { return Span<const T>(data, array_size); }
+
     // Display all elements (works if T supports << operator)
     void display() const {
         std::cout << "[";
@@ -151,8 +334,347 @@ public:
         }
         std::cout << "]";
     }
+
+    // Bulk version: same text, formatted into the writer's buffer
+    void display(BufferedWriter& out) const {
+        out.write_list(as_span());
+    }
 };
 
+// Problem 2.2 (Extension): Fixed-Size Array - SimpleArray<T, N>
+// -----------------------------------------------------------------------------
+// When the size is known at compile time, the elements can live INSIDE the
+// object (on the stack, or inside another object) instead of on the heap:
+// - no new/delete, so creating one is essentially free
+// - aligned to 32 bytes so SIMD instructions can load elements efficiently
+// - constexpr: small tables can even be built by the compiler
+// - operator[] returns a reference (no copy); get() checks bounds and THROWS
+//   instead of printing, so errors cannot be silently ignored
+
+template<typename T, size_t N>
+class SimpleArray {
+    static_assert(N > 0, "SimpleArray<T, N> needs at least one element");
+
+private:
+    static constexpr size_t alignment = alignof(T) > 32 ? alignof(T) : 32;
+    alignas(alignment) T elements[N];
+
+public:
+    // Value-initializes every element (0 for numbers, "" for strings)
+    constexpr SimpleArray() : elements{} {}
+
+    // SimpleArray<int, 3> a = {1, 2, 3};  Missing values stay value-initialized
+    constexpr SimpleArray(std::initializer_list<T> values) : elements{} {
+        if (values.size() > N) {
+            throw std::length_error("Too many initializers for SimpleArray");
+        }
+        size_t i = 0;
+        for (const T& value : values) elements[i++] = value;
+    }
+
+    // Unchecked access - as fast as a built-in array
+    constexpr T& operator[](size_t index) { return elements[index]; }
+    constexpr const T& operator[](size_t index) const { return elements[index]; }
+
+    // Checked access: throws std::out_of_range instead of returning a dummy value
+    constexpr const T& get(size_t index) const {
+        if (index >= N) {
+            throw std::out_of_range("SimpleArray index " + std::to_string(index) + " out of bounds");
+        }
+        return elements[index];
+    }
+
+    constexpr void set(size_t index, const T& value) {
+        if (index >= N) {
+            throw std::out_of_range("SimpleArray index " + std::to_string(index) + " out of bounds");
+        }
+        elements[index] = value;
+    }
+
+    static constexpr size_t size() { return N; }
+
+    constexpr T* data() { return elements; }
+    constexpr const T* data() const { return elements; }
+    constexpr T* begin() { return elements; }
+    constexpr T* end() { return elements + N; }
+    constexpr const T* begin() const { return elements; }
+    constexpr const T* end() const { return elements + N; }
+
+    constexpr Span<T> as_span() { return Span<T>(elements, N); }
+    constexpr Span<const T> as_span() const { return Span<const T>(elements, N); }
+
+    void display() const {
+        std::cout << "[";
+        for (size_t i = 0; i < N; ++i) {
+            std::cout << elements[i];
+            if (i < N - 1) std::cout << ", ";
+        }
+        std::cout << "]";
+    }
+
+    void display(BufferedWriter& out) const {
+        out.write_list(as_span());
+    }
+};
+
+// A "kernel" written once against Span runs over either SimpleArray variant
+template<typename T>
+void scale_in_place(Span<T> values, T factor) {
+    for (size_t i = 0; i < values.size(); ++i) {
+        values[i] *= factor;
+    }
+}
+
+// Built entirely at compile time
+constexpr SimpleArray<int, 8> make_squares() {
+    SimpleArray<int, 8> squares;
+    for (size_t i = 0; i < squares.size(); ++i) {
+        squares[i] = static_cast<int>(i * i);
+    }
+    return squares;
+}
+
+// Reductions over ranges: sum, mean, min, max, dot, Kahan sum
+// -----------------------------------------------------------------------------
+// A plain loop like 'for (x : values) total += x;' is slow for float/double:
+// every addition depends on the previous one, and the compiler may NOT
+// reorder floating-point additions, so it cannot use SIMD instructions.
+//
+// The kernels below keep several INDEPENDENT accumulators ("lanes") and
+// combine them at the end. We chose that order explicitly, so the compiler
+// is free to put the lanes into one SIMD register (4-8 values at a time).
+// No intrinsics needed - this is portable C++ that vectorizes at -O2/-O3.
+//
+// ReduceTraits<T> decides everything per element type at compile time:
+// - sum_type: integers are summed in 64 bits (a sum of many int32 values
+//   easily overflows int32); float and double stay as they are
+// - lanes: enough accumulators to fill a 256-bit register
+//
+// Large ranges are split into fixed-size blocks that several threads reduce
+// in parallel. The block boundaries do not depend on the thread count, so
+// the result is the same on every machine.
+
+namespace reduce {
+
+constexpr size_t parallel_threshold = size_t(1) << 18;  // Elements
+constexpr size_t block_size = size_t(1) << 16;
+
+template<typename T>
+struct ReduceTraits {
+    static_assert(std::is_arithmetic<T>::value && !std::is_same<T, bool>::value,
+                  "reductions need a numeric element type");
+
+    using sum_type = std::conditional_t<std::is_floating_point<T>::value, T,
+                     std::conditional_t<std::is_signed<T>::value, int64_t, uint64_t>>;
+
+    // Integers report their mean as double, floating types as themselves
+    using mean_type = std::conditional_t<std::is_floating_point<T>::value, T, double>;
+
+    static constexpr size_t lanes = 32 / sizeof(sum_type) < 4 ? 4 : 32 / sizeof(sum_type);
+};
+
+namespace detail {
+
+template<typename T>
+typename ReduceTraits<T>::sum_type sum_kernel(const T* data, size_t count) {
+    using S = typename ReduceTraits<T>::sum_type;
+    constexpr size_t L = ReduceTraits<T>::lanes;
+
+    S acc[L] = {};
+    size_t i = 0;
+    for (; i + L <= count; i += L) {
+        for (size_t lane = 0; lane < L; ++lane) {
+            acc[lane] += static_cast<S>(data[i + lane]);
+        }
+    }
+    S total = 0;
+    for (size_t lane = 0; lane < L; ++lane) total += acc[lane];
+    for (; i < count; ++i) total += static_cast<S>(data[i]);  // Leftovers
+    return total;
+}
+
+template<typename T>
+typename ReduceTraits<T>::sum_type dot_kernel(const T* a, const T* b, size_t count) {
+    using S = typename ReduceTraits<T>::sum_type;
+    constexpr size_t L = ReduceTraits<T>::lanes;
+
+    S acc[L] = {};
+    size_t i = 0;
+    for (; i + L <= count; i += L) {
+        for (size_t lane = 0; lane < L; ++lane) {
+            acc[lane] += static_cast<S>(a[i + lane]) * static_cast<S>(b[i + lane]);
+        }
+    }
+    S total = 0;
+    for (size_t lane = 0; lane < L; ++lane) total += acc[lane];
+    for (; i < count; ++i) total += static_cast<S>(a[i]) * static_cast<S>(b[i]);
+    return total;
+}
+
+// Shared by min and max: 'Better' says whether a candidate replaces the current value
+template<typename T, typename Better>
+T extreme_kernel(const T* data, size_t count, Better better) {
+    constexpr size_t L = ReduceTraits<T>::lanes;
+
+    T acc[L];
+    for (size_t lane = 0; lane < L; ++lane) acc[lane] = data[0];
+    size_t i = 0;
+    for (; i + L <= count; i += L) {
+        for (size_t lane = 0; lane < L; ++lane) {
+            // Written as a select (not an if) so it maps to SIMD min/max
+            acc[lane] = better(data[i + lane], acc[lane]) ? data[i + lane] : acc[lane];
+        }
+    }
+    T result = acc[0];
+    for (size_t lane = 1; lane < L; ++lane) result = better(acc[lane], result) ? acc[lane] : result;
+    for (; i < count; ++i) result = better(data[i], result) ? data[i] : result;
+    return result;
+}
+
+// Kahan summation: 'compensation' remembers the low-order bits that were
+// lost in each addition and feeds them back into the next one
+template<typename T>
+struct KahanAccumulator {
+    T sum = 0;
+    T compensation = 0;
+
+    void add(T value) {
+        T corrected = value - compensation;
+        T next = sum + corrected;
+        compensation = (next - sum) - corrected;
+        sum = next;
+    }
+
+    // Folds another accumulator in, including the bits it has not applied yet
+    void merge(const KahanAccumulator& other) {
+        add(other.sum);
+        add(-other.compensation);
+    }
+};
+
+template<typename T>
+KahanAccumulator<T> kahan_kernel(const T* data, size_t count) {
+    constexpr size_t L = ReduceTraits<T>::lanes;
+
+    KahanAccumulator<T> acc[L];
+    size_t i = 0;
+    for (; i + L <= count; i += L) {
+        for (size_t lane = 0; lane < L; ++lane) acc[lane].add(data[i + lane]);
+    }
+    KahanAccumulator<T> total;
+    for (size_t lane = 0; lane < L; ++lane) total.merge(acc[lane]);
+    for (; i < count; ++i) total.add(data[i]);
+    return total;
+}
+
+// Runs 'reduce_block(start, count)' for every block, spread over the
+// available hardware threads, then folds the partial results in block order
+template<typename Result, typename BlockFn, typename Combine>
+Result blocked_reduce(size_t count, BlockFn reduce_block, Combine combine) {
+    const size_t blocks = (count + block_size - 1) / block_size;
+    std::vector<Result> partial(blocks);
+
+    size_t workers = std::max(1u, std::thread::hardware_concurrency());
+    workers = std::min(workers, blocks);
+
+    auto work = [&](size_t worker) {
+        for (size_t b = worker; b < blocks; b += workers) {
+            size_t start = b * block_size;
+            partial[b] = reduce_block(start, std::min(block_size, count - start));
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (size_t w = 1; w < workers; ++w) threads.emplace_back(work, w);
+    work(0);  // The calling thread takes its share too
+    for (auto& t : threads) t.join();
+
+    Result result = partial[0];
+    for (size_t b = 1; b < blocks; ++b) result = combine(result, partial[b]);
+    return result;
+}
+
+}  // namespace detail
+
+template<typename T>
+typename ReduceTraits<T>::sum_type sum(Span<const T> values) {
+    using S = typename ReduceTraits<T>::sum_type;
+    if (values.size() < parallel_threshold) {
+        return detail::sum_kernel(values.data(), values.size());
+    }
+    return detail::blocked_reduce<S>(values.size(),
+        [&](size_t start, size_t count) { return detail::sum_kernel(values.data() + start, count); },
+        [](S a, S b) { return a + b; });
+}
+
+template<typename T>
+typename ReduceTraits<T>::mean_type mean(Span<const T> values) {
+    using M = typename ReduceTraits<T>::mean_type;
+    if (values.empty()) {
+        throw std::invalid_argument("mean of an empty range");
+    }
+    return static_cast<M>(sum(values)) / static_cast<M>(values.size());
+}
+
+template<typename T>
+T min(Span<const T> values) {
+    if (values.empty()) {
+        throw std::invalid_argument("min of an empty range");
+    }
+    auto less = [](T a, T b) { return a < b; };
+    if (values.size() < parallel_threshold) {
+        return detail::extreme_kernel(values.data(), values.size(), less);
+    }
+    return detail::blocked_reduce<T>(values.size(),
+        [&](size_t start, size_t count) { return detail::extreme_kernel(values.data() + start, count, less); },
+        [](T a, T b) { return b < a ? b : a; });
+}
+
+template<typename T>
+T max(Span<const T> values) {
+    if (values.empty()) {
+        throw std::invalid_argument("max of an empty range");
+    }
+    auto greater = [](T a, T b) { return a > b; };
+    if (values.size() < parallel_threshold) {
+        return detail::extreme_kernel(values.data(), values.size(), greater);
+    }
+    return detail::blocked_reduce<T>(values.size(),
+        [&](size_t start, size_t count) { return detail::extreme_kernel(values.data() + start, count, greater); },
+        [](T a, T b) { return b > a ? b : a; });
+}
+
+template<typename T>
+typename ReduceTraits<T>::sum_type dot(Span<const T> a, Span<const T> b) {
+    using S = typename ReduceTraits<T>::sum_type;
+    if (a.size() != b.size()) {
+        throw std::invalid_argument("dot product of ranges with different sizes");
+    }
+    if (a.size() < parallel_threshold) {
+        return detail::dot_kernel(a.data(), b.data(), a.size());
+    }
+    return detail::blocked_reduce<S>(a.size(),
+        [&](size_t start, size_t count) { return detail::dot_kernel(a.data() + start, b.data() + start, count); },
+        [](S x, S y) { return x + y; });
+}
+
+// More accurate than sum() for long float/double ranges, roughly 2x slower.
+// Note: -ffast-math lets the compiler "simplify" the compensation away.
+template<typename T>
+T kahan_sum(Span<const T> values) {
+    static_assert(std::is_floating_point<T>::value, "kahan_sum is only useful for float/double");
+    using Accumulator = detail::KahanAccumulator<T>;
+    if (values.size() < parallel_threshold) {
+        return detail::kahan_kernel(values.data(), values.size()).sum;
+    }
+    // Block results are combined with compensation too
+    return detail::blocked_reduce<Accumulator>(values.size(),
+        [&](size_t start, size_t count) { return detail::kahan_kernel(values.data() + start, count); },
+        [](Accumulator a, const Accumulator& b) { a.merge(b); return a; }).sum;
+}
+
+}  // namespace reduce
+
 // =============================================================================
 // PROBLEM SET 3: TEMPLATE SPECIALIZATION AND DEBUGGING
 // =============================================================================
@@ -166,6 +688,13 @@ public:
     static void print(const T& value) {
         std::cout << "Value: " << value << std::endl;
     }
+
+    // Buffered version: no flush per line, no stream formatting state
+    static void print(const T& value, BufferedWriter& out) {
+        out.write("Value: ");
+        out.write_value(value);
+        out.put('\n');
+    }
 };
 
 // Template specialization for bool
@@ -176,6 +705,10 @@ public:
     static void print(const bool& value) {
         std::cout << "Boolean: " << (value ? "true" : "false") << std::endl;
     }
+
+    static void print(const bool& value, BufferedWriter& out) {
+        out.write(value ? "Boolean: true\n" : "Boolean: false\n");
+    }
 };
 
 // Template specialization for string
@@ -186,6 +719,12 @@ public:
     static void print(const std::string& value) {
         std::cout << "Text: " << value << std::endl;
     }
+
+    static void print(const std::string& value, BufferedWriter& out) {
+        out.write("Text: ");
+        out.write(value);
+        out.put('\n');
+    }
 };
 
 // Problem 3.2: Debugging Template Errors
@@ -204,6 +743,17 @@ public:
         value += amount;
     }
 
+    // Adds a whole range at once using the vectorized reduction kernels.
+    // The range is summed in ReduceTraits<T>::sum_type (64 bits for
+    // integers) and then converted to T, so the result equals calling add()
+    // for each element only when that sum fits in T. If it does not, the
+    // conversion silently narrows it (an int wraps around), where the
+    // add() loop would have overflowed along the way. For float/double the
+    // different order of additions can also change the last bits.
+    void add_all(Span<const T> amounts) {
+        value += static_cast<T>(reduce::sum(amounts));
+    }
+
     void print() const {
         std::cout << "Result: " << value << std::endl;
     }
@@ -230,6 +780,12 @@ T average(T a, T b) {
     return (a + b) / 2;  // Only works if T supports + and /
 }
 
+// Overload for a whole range: average of many values in one vectorized pass
+template<typename T>
+typename reduce::ReduceTraits<T>::mean_type average(Span<const T> values) {
+    return reduce::mean(values);
+}
+
 // Example: Template class with multiple type parameters
 template<typename KeyType, typename ValueType>
 class KeyValuePair {
@@ -238,16 +794,130 @@ private:
     ValueType value;
 
 public:
-    KeyValuePair(KeyType k, ValueType v) : key(k), value(v) {}
+    KeyValuePair(KeyType k, ValueType v) : key(std::move(k)), value(std::move(v)) {}
 
-    KeyType getKey() const { return key; }
-    ValueType getValue() const { return value; }
+    // Returning const references avoids copying large keys (e.g. strings)
+    const KeyType& getKey() const { return key; }
+    const ValueType& getValue() const { return value; }
+    void setValue(ValueType v) { value = std::move(v); }
 
     void display() const {
         std::cout << key << " => " << value;
     }
 };
 
+// Example: FlatMap - a sorted table of KeyValuePairs in one contiguous array
+// -----------------------------------------------------------------------------
+// std::map stores every entry in its own heap node; each lookup follows
+// about log2(n) pointers to nodes scattered around memory (a cache miss
+// almost every step). FlatMap keeps the entries SORTED in a std::vector:
+// - binary search touches nearby memory, and the top levels of the search
+//   stay in cache across lookups
+// - no per-entry allocation, far less memory per entry
+// - iteration is a simple linear scan, in key order
+//
+// The price: inserting one entry in the middle shifts everything after it
+// (O(n)). FlatMap is meant for tables that are built once (bulk
+// construction) and then read many times - configs, catalogs, lookup tables.
+
+template<typename KeyType, typename ValueType, typename Compare = std::less<KeyType>>
+class FlatMap {
+public:
+    using Entry = KeyValuePair<KeyType, ValueType>;
+
+private:
+    std::vector<Entry> entries;  // Sorted by key, no duplicate keys
+    Compare less;
+
+    // Branchless binary search: index of the first entry whose key is not
+    // less than 'key'. The loop always runs log2(n) times and the 'if' is a
+    // simple select (cmov), so there are no mispredicted branches to pay for.
+    // (For numeric keys; comparing strings has branches of its own.)
+    size_t lower_bound_index(const KeyType& key) const {
+        size_t n = entries.size();
+        if (n == 0) return 0;
+        const Entry* base = entries.data();
+        while (n > 1) {
+            size_t half = n / 2;
+            base = less(base[half].getKey(), key) ? base + half : base;
+            n -= half;
+        }
+        return static_cast<size_t>(base - entries.data()) + (less(base->getKey(), key) ? 1 : 0);
+    }
+
+    bool matches(size_t index, const KeyType& key) const {
+        return index < entries.size() && !less(key, entries[index].getKey());
+    }
+
+public:
+    FlatMap() = default;
+
+    // Bulk construction from UNSORTED input: one sort instead of n inserts.
+    // For duplicate keys the LAST occurrence wins (like repeated assignment).
+    explicit FlatMap(std::vector<Entry> items) : entries(std::move(items)) {
+        std::stable_sort(entries.begin(), entries.end(), [this](const Entry& a, const Entry& b) {
+            return less(a.getKey(), b.getKey());
+        });
+        // Keep the last of each run of equal keys
+        size_t out = 0;
+        for (size_t i = 0; i < entries.size(); ++i) {
+            bool last_of_run = i + 1 == entries.size() ||
+                               less(entries[i].getKey(), entries[i + 1].getKey());
+            if (last_of_run) {
+                if (out != i) entries[out] = std::move(entries[i]);
+                ++out;
+            }
+        }
+        entries.erase(entries.begin() + static_cast<std::ptrdiff_t>(out), entries.end());
+    }
+
+    FlatMap(std::initializer_list<Entry> items) : FlatMap(std::vector<Entry>(items)) {}
+
+    size_t size() const { return entries.size(); }
+    bool empty() const { return entries.empty(); }
+
+    // Iteration in key order
+    auto begin() const { return entries.begin(); }
+    auto end() const { return entries.end(); }
+
+    // Returns nullptr if the key is missing (no exception on the fast path)
+    const ValueType* find(const KeyType& key) const {
+        size_t index = lower_bound_index(key);
+        return matches(index, key) ? &entries[index].getValue() : nullptr;
+    }
+
+    bool contains(const KeyType& key) const {
+        return find(key) != nullptr;
+    }
+
+    const ValueType& at(const KeyType& key) const {
+        const ValueType* value = find(key);
+        if (!value) {
+            throw std::out_of_range("FlatMap::at: key not found");
+        }
+        return *value;
+    }
+
+    // O(n) when the key is new - fine now and then, slow in a loop
+    // (collect the entries and use the bulk constructor instead)
+    void insert_or_assign(KeyType key, ValueType value) {
+        size_t index = lower_bound_index(key);
+        if (matches(index, key)) {
+            entries[index].setValue(std::move(value));
+        } else {
+            entries.insert(entries.begin() + static_cast<std::ptrdiff_t>(index),
+                           Entry(std::move(key), std::move(value)));
+        }
+    }
+
+    bool erase(const KeyType& key) {
+        size_t index = lower_bound_index(key);
+        if (!matches(index, key)) return false;
+        entries.erase(entries.begin() + static_cast<std::ptrdiff_t>(index));
+        return true;
+    }
+};
+
 // Example: Template function that works with arrays
 template<typename T, size_t N>
 void print_array(const T (&arr)[N]) {
@@ -259,6 +929,19 @@ void print_array(const T (&arr)[N]) {
     std::cout << "]" << std::endl;
 }
 
+// Bulk overloads: the whole array is formatted into the writer's buffer
+template<typename T, size_t N>
+void print_array(const T (&arr)[N], BufferedWriter& out) {
+    out.write_list(Span<const T>(arr, N));
+    out.put('\n');
+}
+
+template<typename T>
+void print_array(Span<const T> values, BufferedWriter& out) {
+    out.write_list(values);
+    out.put('\n');
+}
+
 // =============================================================================
 // DEMONSTRATION FUNCTIONS
 // =============================================================================
@@ -349,6 +1032,39 @@ void demo_template_classes() {
         std::cout << "\n";
     } // Arrays destroyed here - watch destructor messages
     std::cout << "\n";
+
+    // Problem 2.2 (Extension): fixed-size arrays and spans
+    std::cout << "2.2 (Extension) Fixed-Size SimpleArray<T, N>:\n";
+    {
+        constexpr auto squares = make_squares();
+        static_assert(squares[3] == 9, "Computed by the compiler");
+        std::cout << "Compile-time squares: ";
+        squares.display();
+        std::cout << "\n";
+
+        SimpleArray<double, 4> weights = {0.5, 1.5, 2.5};  // No heap allocation
+        std::cout << "Fixed array (alignment " << alignof(SimpleArray<double, 4>) << "): ";
+        weights.display();
+        std::cout << "\n";
+
+        SimpleArray<double> readings(4);  // Heap version, same kernel below
+        for (size_t i = 0; i < readings.size(); ++i) readings.set(i, 10.0 * (i + 1));
+
+        scale_in_place(weights.as_span(), 2.0);
+        scale_in_place(readings.as_span(), 2.0);
+        std::cout << "After scale_in_place(x2): ";
+        weights.display();
+        std::cout << " and ";
+        readings.display();
+        std::cout << "\n";
+
+        try {
+            weights.get(10);
+        } catch (const std::out_of_range& e) {
+            std::cout << "Caught: " << e.what() << "\n";
+        }
+    }
+    std::cout << "\n";
 }
 
 void demo_specialization() {
@@ -361,6 +1077,56 @@ void demo_specialization() {
     Printer<std::string>::print("hello world");
     Printer<double>::print(3.14159);
     std::cout << "\n";
+
+    std::cout << "3.1 (Extension) Printing through a BufferedWriter:\n";
+    {
+        BufferedWriter out;
+        Printer<int>::print(42, out);
+        Printer<bool>::print(true, out);
+        Printer<std::string>::print("hello world", out);
+        Printer<double>::print(3.14159, out);
+    }  // Destructor flushes - same text as above, one write
+    std::cout << "\n";
+
+    // Dumping a large array: iostream element by element vs. BufferedWriter
+    const size_t count = 2000000;
+    std::vector<double> values(count);
+    for (size_t i = 0; i < count; ++i) values[i] = static_cast<double>(i) * 0.25;
+
+    using clock = std::chrono::steady_clock;
+    auto to_ms = [](clock::duration d) {
+        return std::chrono::duration<double, std::milli>(d).count();
+    };
+
+    auto start = clock::now();
+    {
+        std::ofstream file("print_iostream.txt");
+        file << "[";
+        for (size_t i = 0; i < count; ++i) {
+            file << values[i];
+            if (i < count - 1) file << ", ";
+        }
+        file << "]\n";
+    }
+    auto stream_time = clock::now() - start;
+
+    start = clock::now();
+    {
+        std::FILE* file = std::fopen("print_buffered.txt", "w");
+        if (file) {
+            {
+                BufferedWriter out(file);
+                print_array(Span<const double>(values.data(), values.size()), out);
+            }  // Flush before closing
+            std::fclose(file);
+        }
+    }
+    auto buffered_time = clock::now() - start;
+
+    std::cout << "Writing " << count << " doubles:\n";
+    std::cout << "  iostream, one element at a time: " << to_ms(stream_time) << " ms\n";
+    std::cout << "  BufferedWriter + to_chars:       " << to_ms(buffered_time) << " ms\n";
+    std::cout << "(print_iostream.txt and print_buffered.txt contain identical text)\n\n";
 }
 
 void demo_calculator() {
@@ -378,6 +1144,11 @@ void demo_calculator() {
     calc_double.add(2.5);
     std::cout << "After add(2.5): " << calc_double.getValue() << "\n";
     calc_double.print();
+
+    // Adding many values at once
+    const int more[] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+    calc.add_all(Span<const int>(more, 10));
+    std::cout << "After add_all(1..10): " << calc.getValue() << "\n";
     std::cout << "\n";
 }
 
@@ -405,15 +1176,175 @@ void demo_advanced_templates() {
     double values[] = {3.14, 2.71, 1.41};
     std::cout << "  ";
     print_array(values);
+
+    {
+        BufferedWriter out;
+        out.write("  ");
+        print_array(values, out);  // Bulk overload, same output
+    }
     std::cout << "\n";
 
     // Average function
     std::cout << "Generic average function:\n";
     std::cout << "  average(10, 20) = " << average(10, 20) << "\n";
     std::cout << "  average(3.5, 6.5) = " << average(3.5, 6.5) << "\n";
+    std::cout << "  average({1, 2, 3, 4}) = " << average(Span<const int>(numbers, 4)) << "\n";
     std::cout << "\n";
 }
 
+void demo_flat_map() {
+    std::cout << "=== FLATMAP: SORTED CONTIGUOUS LOOKUP TABLE ===\n\n";
+
+    // Built in one step from unsorted input; the duplicate "timeout" keeps
+    // the last value
+    FlatMap<std::string, int> config({
+        {"timeout", 30}, {"retries", 3}, {"port", 8080}, {"timeout", 45}, {"workers", 8}
+    });
+    std::cout << "Config entries in key order:\n";
+    for (const auto& entry : config) {
+        std::cout << "  ";
+        entry.display();
+        std::cout << "\n";
+    }
+    std::cout << "  at(\"timeout\") = " << config.at("timeout") << "\n";
+    std::cout << "  contains(\"verbose\") = " << (config.contains("verbose") ? "yes" : "no") << "\n";
+    config.insert_or_assign("verbose", 1);
+    std::cout << "  after insert_or_assign: size = " << config.size() << "\n";
+    try {
+        config.at("missing");
+    } catch (const std::out_of_range& e) {
+        std::cout << "  at(\"missing\") -> out_of_range: " << e.what() << "\n";
+    }
+    std::cout << "\n";
+
+    // Benchmark: a catalog of a few thousand entries, many random lookups
+    const int table_size = 4000;
+    const int lookups = 2000000;
+
+    std::mt19937 rng(42);
+    std::vector<int> keys(table_size);
+    for (int i = 0; i < table_size; ++i) keys[i] = i * 7 + 3;  // Spread-out ids
+    std::vector<KeyValuePair<int, int>> items;
+    std::map<int, int> tree;
+    std::unordered_map<int, int> hashed;
+    for (int key : keys) {
+        items.emplace_back(key, key * 2);
+        tree[key] = key * 2;
+        hashed[key] = key * 2;
+    }
+    std::shuffle(items.begin(), items.end(), rng);
+    FlatMap<int, int> flat(std::move(items));
+
+    // Same probe sequence for all three; about half the probes miss
+    std::vector<int> probes(lookups);
+    std::uniform_int_distribution<int> pick(0, table_size * 7 + 3);
+    for (int& probe : probes) probe = pick(rng);
+
+    using clock = std::chrono::steady_clock;
+    auto to_ms = [](clock::duration d) {
+        return std::chrono::duration<double, std::milli>(d).count();
+    };
+
+    auto start = clock::now();
+    long long tree_hits = 0;
+    for (int probe : probes) {
+        auto it = tree.find(probe);
+        if (it != tree.end()) tree_hits += it->second;
+    }
+    auto tree_time = clock::now() - start;
+
+    start = clock::now();
+    long long hash_hits = 0;
+    for (int probe : probes) {
+        auto it = hashed.find(probe);
+        if (it != hashed.end()) hash_hits += it->second;
+    }
+    auto hash_time = clock::now() - start;
+
+    start = clock::now();
+    long long flat_hits = 0;
+    for (int probe : probes) {
+        if (const int* value = flat.find(probe)) flat_hits += *value;
+    }
+    auto flat_time = clock::now() - start;
+
+    std::cout << lookups << " lookups in a table of " << table_size << " entries:\n";
+    std::cout << "  std::map:           " << to_ms(tree_time) << " ms\n";
+    std::cout << "  std::unordered_map: " << to_ms(hash_time) << " ms\n";
+    std::cout << "  FlatMap:            " << to_ms(flat_time) << " ms\n";
+    std::cout << "  (checksums " << (tree_hits == flat_hits && hash_hits == flat_hits ? "match" : "DIFFER")
+              << ")\n\n";
+}
+
+void demo_reductions() {
+    std::cout << "=== REDUCTIONS OVER RANGES ===\n\n";
+
+    const double prices[] = {4.5, 12.0, 3.25, 8.75, 1.5};
+    const double quantities[] = {2, 1, 4, 1, 10};
+    Span<const double> p(prices, 5);
+    Span<const double> q(quantities, 5);
+
+    std::cout << "Small examples:\n";
+    std::cout << "  sum(prices)             = " << reduce::sum(p) << "\n";
+    std::cout << "  mean(prices)            = " << reduce::mean(p) << "\n";
+    std::cout << "  min / max               = " << reduce::min(p) << " / " << reduce::max(p) << "\n";
+    std::cout << "  dot(prices, quantities) = " << reduce::dot(p, q) << "\n";
+
+    // int32 values are summed in 64 bits, so this does not overflow
+    std::vector<int32_t> big_ints(1000, 2000000000);
+    std::cout << "  sum of 1000 x 2e9 (int32 input) = "
+              << reduce::sum(Span<const int32_t>(big_ints.data(), big_ints.size())) << "\n";
+
+    try {
+        reduce::mean(Span<const double>());
+    } catch (const std::invalid_argument& e) {
+        std::cout << "  mean of nothing -> invalid_argument: " << e.what() << "\n";
+    }
+    std::cout << "\n";
+
+    // Accuracy: adding 0.1f ten million times should give 1,000,000
+    const size_t count = 10000000;
+    std::vector<float> tenths(count, 0.1f);
+    Span<const float> t(tenths.data(), tenths.size());
+    float naive = 0.0f;
+    for (float x : tenths) naive += x;
+    std::cout << "Adding 0.1f " << count << " times (exact: 1000000):\n";
+    std::cout << "  naive loop: " << naive << "\n";
+    std::cout << "  sum():      " << reduce::sum(t) << "\n";
+    std::cout << "  kahan_sum(): " << reduce::kahan_sum(t) << "\n\n";
+
+    // Speed: the same sum written as a plain loop vs. reduce::sum
+    std::vector<float> samples(count);
+    for (size_t i = 0; i < count; ++i) samples[i] = static_cast<float>(i % 1000) * 0.001f;
+    Span<const float> s(samples.data(), samples.size());
+
+    using clock = std::chrono::steady_clock;
+    auto to_ms = [](clock::duration d) {
+        return std::chrono::duration<double, std::milli>(d).count();
+    };
+    const int repeats = 10;
+
+    auto start = clock::now();
+    float plain_total = 0.0f;
+    for (int r = 0; r < repeats; ++r) {
+        float total = 0.0f;
+        for (float x : samples) total += x;  // One long dependency chain
+        plain_total += total;
+    }
+    auto plain_time = clock::now() - start;
+
+    start = clock::now();
+    float parallel_total = 0.0f;
+    for (int r = 0; r < repeats; ++r) parallel_total += reduce::sum(s);
+    auto parallel_time = clock::now() - start;
+
+    std::cout << "Summing " << count << " floats, " << repeats << " times ("
+              << std::thread::hardware_concurrency() << " hardware threads):\n";
+    std::cout << "  plain loop:  " << to_ms(plain_time) << " ms (total " << plain_total << ")\n";
+    std::cout << "  reduce::sum: " << to_ms(parallel_time) << " ms (total " << parallel_total << ")\n";
+    std::cout << "(totals differ slightly: float addition order changes rounding)\n\n";
+}
+
 // =============================================================================
 // MAIN FUNCTION
 // =============================================================================
@@ -430,6 +1361,8 @@ int main() {
     demo_specialization();
     demo_calculator();
     demo_advanced_templates();
+    demo_flat_map();
+    demo_reductions();
 
     std::cout << "═══════════════════════════════════════════════════════════\n";
     std::cout << "All demonstrations complete!\n";
@@ -491,6 +1424,34 @@ KEY LEARNING POINTS FOR CHAPTER 6: TEMPLATES
    - Document what operations T must support
    - Test with multiple types (int, double, string, custom classes)
 
+9. NON-TYPE TEMPLATE PARAMETERS AND VIEWS:
+   - template<typename T, size_t N> puts the size into the type itself
+   - Fixed-size storage lives inside the object - no heap allocation
+   - Partial specialization lets SimpleArray<T> and SimpleArray<T, N> coexist
+   - Span<T> (std::span in C++20) lets one function work on any contiguous data
+
+10. FAST OUTPUT FOR LARGE DATA:
+   - std::endl flushes every line; use '\n' unless you need the flush
+   - Writing element by element through << pays stream overhead per value
+   - BufferedWriter formats with std::to_chars into one buffer and writes
+     it in large chunks - the text is identical, only faster
+   - if constexpr picks the right formatting path per type at compile time
+
+11. CONTAINERS AND MEMORY LAYOUT:
+   - std::map allocates a node per entry; lookups chase pointers
+   - A sorted vector (FlatMap) gives the same O(log n) lookups with far
+     fewer cache misses, at the cost of O(n) single inserts
+   - Build read-mostly tables in bulk: collect, sort once, then query
+   - The Compare template parameter (default std::less) works like std::map's
+
+12. GENERIC NUMERIC KERNELS:
+   - A traits struct (ReduceTraits<T>) picks accumulator type and lane count
+     per element type at compile time
+   - Several independent accumulators let the compiler use SIMD even for
+     float/double, where it may not reorder a single running sum
+   - Fixed-size blocks make multi-threaded results reproducible
+   - Kahan summation trades speed for accuracy on long float ranges
+
 =============================================================================
 DEBUGGING TIPS:
 =============================================================================
@@ -507,10 +1468,17 @@ EXAMPLE COMPILATION AND TESTING:
 =============================================================================
 
 To compile this file:
-  g++ -std=c++11 templates_hints.cpp -o templates_hints
+  g++ -std=c++17 -pthread templates_hints.cpp -o templates_hints
 
 Or with more warnings:
-  g++ -std=c++11 -Wall -Wextra templates_hints.cpp -o templates_hints
+  g++ -std=c++17 -Wall -Wextra -pthread templates_hints.cpp -o templates_hints
+
+With -std=c++20, Span becomes an alias for std::span automatically.
+
+The BufferedWriter benchmark writes print_iostream.txt and print_buffered.txt
+in the current directory; compile with -O2 (or -O3) for meaningful timings.
+Without optimization nothing is vectorized and the reduction timings are
+meaningless.
 
 To run:
   ./templates_hints
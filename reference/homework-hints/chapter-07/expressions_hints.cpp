@@ -2,6 +2,21 @@
 #include <iomanip>
 #include <cmath>
 #include <string>
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 // =============================================================================
 // CHAPTER 7: EXPRESSIONS - COMPREHENSIVE HOMEWORK HINTS
@@ -246,8 +261,168 @@ public:
 
     // Getter for testing
     int get_cents() const { return cents; }
+
+    // Named factory: makes "this number is cents" explicit at the call site
+    static Money from_cents(int total_cents) {
+        return Money(total_cents, true);
+    }
+};
+
+// -----------------------------------------------------------------------------
+// Problem 2.1 (Extension): Reading and Writing Money as Text, Fast
+// -----------------------------------------------------------------------------
+// Ledger exports contain millions of amounts like "1234.56" or "-0.05".
+// Reading them with 'stream >> double' is slow (locale, stream state,
+// floating point) and converting through double can even round 0.29 * 100
+// to 28.999... . These routines work on the characters directly:
+//
+// - parse_money() follows the std::from_chars convention: it takes a
+//   [first, last) character range and returns where it stopped plus an
+//   error code (no exceptions, no allocation)
+// - long digit runs are checked and converted 8 characters at a time
+//   with one 64-bit integer ("SWAR" - SIMD within a register)
+// - format_money() follows std::to_chars: it writes into a buffer the
+//   caller provides and reports value_too_large if it does not fit
+//
+// Accepted format: optional '-', at least one digit, then optionally '.'
+// followed by one or two digits ("7", "7.5", "7.50", "-0.05").
+
+struct MoneyParseResult {
+    const char* ptr;  // First character not consumed
+    errc ec;          // errc() on success
 };
 
+// True if all 8 bytes are '0'..'9'. Each test runs on all 8 bytes at once:
+// digits are 0x30..0x39, so the high nibble must be 3, and adding 6 must
+// not carry into the high nibble (0x39 + 6 = 0x3F, but 0x3A + 6 = 0x40)
+inline bool all_eight_digits(uint64_t chunk) {
+    return (chunk & 0xF0F0F0F0F0F0F0F0ULL) == 0x3030303030303030ULL &&
+           ((chunk + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) == 0x3030303030303030ULL;
+}
+
+// Converts 8 digit characters to their value with three multiplications
+// instead of eight (pairs of digits, then pairs of pairs, then halves).
+// The first character is the lowest byte on little-endian machines.
+inline uint32_t eight_digits_value(uint64_t chunk) {
+    chunk -= 0x3030303030303030ULL;
+    chunk = (chunk * 10) + (chunk >> 8);
+    chunk = (((chunk & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32))) +
+             (((chunk >> 16) & 0x000000FF000000FFULL) * (1 + (10000ULL << 32)))) >> 32;
+    return static_cast<uint32_t>(chunk);
+}
+
+inline bool is_digit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+MoneyParseResult parse_money(const char* first, const char* last, Money& value) {
+    const char* p = first;
+    bool negative = p < last && *p == '-';
+    if (negative) ++p;
+
+    const char* digits_start = p;
+    uint64_t dollars = 0;
+    bool too_big = false;
+
+#if !defined(__BYTE_ORDER__) || __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    // Fast path: 8 digits per step while at least 8 characters remain
+    while (last - p >= 8) {
+        uint64_t chunk;
+        memcpy(&chunk, p, 8);  // memcpy: safe for unaligned data
+        if (!all_eight_digits(chunk)) break;
+        too_big = too_big || dollars >= 100000000000ULL;  // Would exceed 19 digits
+        dollars = dollars * 100000000ULL + eight_digits_value(chunk);
+        p += 8;
+    }
+#endif
+    // The remaining (fewer than 8) digits, one at a time
+    while (p < last && is_digit(*p)) {
+        too_big = too_big || dollars >= 100000000000000000ULL;
+        dollars = dollars * 10 + static_cast<uint64_t>(*p - '0');
+        ++p;
+    }
+    if (p == digits_start) {
+        return {first, errc::invalid_argument};  // No digits at all
+    }
+
+    uint64_t fraction = 0;
+    if (p < last && *p == '.') {
+        const char* fraction_start = ++p;
+        while (p < last && is_digit(*p) && p - fraction_start < 2) {
+            fraction = fraction * 10 + static_cast<uint64_t>(*p - '0');
+            ++p;
+        }
+        if (p == fraction_start || (p < last && is_digit(*p))) {
+            return {first, errc::invalid_argument};  // "5." or more than 2 decimals
+        }
+        if (p - fraction_start == 1) fraction *= 10;  // "7.5" means 7.50
+    }
+
+    // Overflow check: the result must fit Money's int cents
+    const uint64_t limit = negative ? static_cast<uint64_t>(INT_MAX) + 1 : INT_MAX;
+    if (too_big || dollars > (limit - fraction) / 100) {
+        return {p, errc::result_out_of_range};
+    }
+    uint64_t cents = dollars * 100 + fraction;
+    value = Money::from_cents(negative ? static_cast<int>(-static_cast<long long>(cents))
+                                       : static_cast<int>(cents));
+    return {p, errc()};
+}
+
+// Parses a whole column: values separated by ',' or line breaks ("\n" or
+// "\r\n"). Stops at the first bad value; the result tells where it is.
+MoneyParseResult parse_money_column(const char* first, const char* last, vector<Money>& out) {
+    const char* p = first;
+    while (p < last) {
+        Money amount;
+        MoneyParseResult result = parse_money(p, last, amount);
+        if (result.ec != errc()) return result;
+        out.push_back(amount);
+        p = result.ptr;
+        if (p < last && *p == '\r') ++p;
+        if (p < last) {
+            if (*p != '\n' && *p != ',') return {p, errc::invalid_argument};
+            ++p;
+        }
+    }
+    return {p, errc()};
+}
+
+// Writes "-1234.56" style text (no '$', so it can go back into a CSV)
+to_chars_result format_money(char* first, char* last, Money value) {
+    long long cents = value.get_cents();  // long long: -INT_MIN must fit
+    bool negative = cents < 0;
+    if (negative) cents = -cents;
+
+    char* p = first;
+    if (negative) {
+        if (p == last) return {last, errc::value_too_large};
+        *p++ = '-';
+    }
+    to_chars_result dollars = to_chars(p, last, cents / 100);
+    if (dollars.ec != errc() || last - dollars.ptr < 3) {
+        return {last, errc::value_too_large};
+    }
+    p = dollars.ptr;
+    *p++ = '.';
+    *p++ = static_cast<char>('0' + cents % 100 / 10);
+    *p++ = static_cast<char>('0' + cents % 10);
+    return {p, errc()};
+}
+
+// Formats many values, each followed by 'separator'
+to_chars_result format_money_column(const vector<Money>& values, char* first, char* last,
+                                    char separator = '\n') {
+    char* p = first;
+    for (const Money& amount : values) {
+        to_chars_result result = format_money(p, last, amount);
+        if (result.ec != errc() || result.ptr == last) return {last, errc::value_too_large};
+        p = result.ptr;
+        *p++ = separator;
+    }
+    return {p, errc()};
+}
+
 void money_class_demo() {
     cout << "\n=== Problem 2.1: Money Class with Arithmetic ===\n\n";
 
@@ -296,6 +471,105 @@ void money_class_demo() {
     cout << "4. Implement comparison operators in terms of < and ==\n";
 }
 
+void money_codec_demo() {
+    cout << "\n=== Problem 2.1 (Extension): Parsing and Formatting Money ===\n\n";
+
+    string column = "1234.56\n-0.05\n7.5\n19.99\r\n1000000.01,0\n";
+    vector<Money> amounts;
+    MoneyParseResult parsed = parse_money_column(column.data(), column.data() + column.size(), amounts);
+    cout << "Parsed " << amounts.size() << " values ("
+         << (parsed.ec == errc() ? "ok" : "error") << "):";
+    for (const Money& m : amounts) cout << " " << m.get_cents();
+    cout << " (cents)\n";
+
+    char buffer[256];
+    to_chars_result written = format_money_column(amounts, buffer, buffer + sizeof(buffer), ',');
+    cout << "Formatted back: " << string(buffer, written.ptr) << "\n";
+
+    const char* bad_inputs[] = {"12.345", "abc", "5.", "99999999999.00", "21474836.48", "-21474836.48"};
+    for (const char* text : bad_inputs) {
+        Money m;
+        MoneyParseResult result = parse_money(text, text + strlen(text), m);
+        cout << "  \"" << text << "\" -> "
+             << (result.ec == errc() ? "ok, " + to_string(m.get_cents()) + " cents"
+                 : result.ec == errc::result_out_of_range ? string("out of range")
+                 : string("invalid"));
+        cout << "\n";
+    }
+
+    // Benchmark: a ledger column with 2 million amounts
+    const size_t count = 2000000;
+    string ledger;
+    ledger.reserve(count * 12);
+    unsigned long long state = 987654321;
+    for (size_t i = 0; i < count; ++i) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        long long cents = static_cast<long long>(state >> 40) % 200000000 - 100000000;
+        char text[32];
+        to_chars_result r = format_money(text, text + sizeof(text), Money::from_cents(static_cast<int>(cents)));
+        ledger.append(text, r.ptr);
+        ledger += '\n';
+    }
+
+    using clock = chrono::steady_clock;
+    auto to_ms = [](clock::duration d) { return chrono::duration<double, milli>(d).count(); };
+
+    auto start = clock::now();
+    vector<Money> via_stream;
+    via_stream.reserve(count);
+    {
+        istringstream in(ledger);
+        double amount;
+        while (in >> amount) {
+            via_stream.push_back(Money::from_cents(static_cast<int>(llround(amount * 100))));
+        }
+    }
+    auto stream_time = clock::now() - start;
+
+    start = clock::now();
+    vector<Money> via_codec;
+    via_codec.reserve(count);
+    parse_money_column(ledger.data(), ledger.data() + ledger.size(), via_codec);
+    auto codec_time = clock::now() - start;
+
+    start = clock::now();
+    string stream_text;
+    {
+        ostringstream out;
+        for (const Money& m : via_codec) {
+            int cents = m.get_cents();
+            if (cents < 0) out << '-';
+            out << abs(cents) / 100 << '.' << setfill('0') << setw(2) << abs(cents) % 100 << '\n';
+        }
+        stream_text = out.str();
+    }
+    auto stream_format_time = clock::now() - start;
+
+    start = clock::now();
+    string codec_text(count * 14, '\0');  // Worst case per value, allocated once
+    to_chars_result end = format_money_column(via_codec, &codec_text[0], &codec_text[0] + codec_text.size());
+    codec_text.resize(static_cast<size_t>(end.ptr - codec_text.data()));
+    auto codec_format_time = clock::now() - start;
+
+    double megabytes = static_cast<double>(ledger.size()) / 1e6;
+    cout << "\n" << count << " amounts (" << megabytes << " MB of text):\n";
+    cout << "  parse, istringstream >> double: " << to_ms(stream_time) << " ms\n";
+    cout << "  parse, parse_money_column:      " << to_ms(codec_time) << " ms ("
+         << megabytes / (to_ms(codec_time) / 1000.0) << " MB/s)\n";
+    cout << "  format, ostream with setw:      " << to_ms(stream_format_time) << " ms\n";
+    cout << "  format, format_money_column:    " << to_ms(codec_format_time) << " ms\n";
+    cout << "  round trip matches input: " << (codec_text == ledger && stream_text == ledger ? "yes" : "NO")
+         << ", both parsers agree: " << (via_stream.size() == via_codec.size() &&
+                                         equal(via_stream.begin(), via_stream.end(), via_codec.begin())
+                                         ? "yes" : "NO") << "\n";
+
+    cout << "\nKey Points:\n";
+    cout << "1. Parse money straight into integer cents - never through double\n";
+    cout << "2. from_chars/to_chars style: ranges in, position + error code out\n";
+    cout << "3. Check for overflow BEFORE the value is stored\n";
+    cout << "4. Formatting into a caller's buffer avoids per-value allocations\n";
+}
+
 // -----------------------------------------------------------------------------
 // Problem 2.2: Vector2D with Mathematical Operations
 // -----------------------------------------------------------------------------
@@ -410,6 +684,735 @@ void vector2d_demo() {
     cout << "4. Be careful with floating-point comparisons - use epsilon\n";
 }
 
+// -----------------------------------------------------------------------------
+// Problem 2.2 (Extension): Vec2Array - Millions of Vectors at Once
+// -----------------------------------------------------------------------------
+// Vector2D is perfect for a few vectors. For millions (particles, telemetry)
+// two things hurt:
+// 1. Layout: an array of Vector2D stores x,y,x,y,... ("array of structures").
+//    Vec2Array stores all x values in one array and all y values in another
+//    ("structure of arrays"), so a loop over x[] can be turned into SIMD
+//    instructions that process 2-4 doubles per step.
+// 2. Temporaries: 'positions + velocities * dt' on whole arrays would first
+//    build a full temporary array for 'velocities * dt', then a second pass
+//    adds it. With EXPRESSION TEMPLATES, operator* and operator+ do no work -
+//    they return small objects that DESCRIBE the computation. The work
+//    happens in ONE loop when the expression is assigned to a Vec2Array.
+//
+// Each expression node knows how to compute element i (x(i) and y(i)).
+// Vec2Expr<E> is the common base (CRTP) so the operators accept any node.
+
+template<typename E>
+class Vec2Expr {
+public:
+    const E& self() const { return static_cast<const E&>(*this); }
+    double x(size_t i) const { return self().x(i); }
+    double y(size_t i) const { return self().y(i); }
+    size_t size() const { return self().size(); }
+};
+
+class Vec2Array;
+
+// Arrays are held by reference (they outlive the expression); intermediate
+// nodes are small and held by value, so 'auto e = a + b * s;' stays valid
+template<typename E>
+using Vec2Operand = typename std::conditional<std::is_same<E, Vec2Array>::value,
+                                              const Vec2Array&, const E>::type;
+
+template<typename L, typename R>
+class Vec2Sum : public Vec2Expr<Vec2Sum<L, R>> {
+private:
+    Vec2Operand<L> left;
+    Vec2Operand<R> right;
+
+public:
+    Vec2Sum(const L& l, const R& r) : left(l), right(r) {
+        if (l.size() != r.size()) throw invalid_argument("Vec2Array sizes differ");
+    }
+    double x(size_t i) const { return left.x(i) + right.x(i); }
+    double y(size_t i) const { return left.y(i) + right.y(i); }
+    size_t size() const { return left.size(); }
+};
+
+template<typename L, typename R>
+class Vec2Difference : public Vec2Expr<Vec2Difference<L, R>> {
+private:
+    Vec2Operand<L> left;
+    Vec2Operand<R> right;
+
+public:
+    Vec2Difference(const L& l, const R& r) : left(l), right(r) {
+        if (l.size() != r.size()) throw invalid_argument("Vec2Array sizes differ");
+    }
+    double x(size_t i) const { return left.x(i) - right.x(i); }
+    double y(size_t i) const { return left.y(i) - right.y(i); }
+    size_t size() const { return left.size(); }
+};
+
+template<typename E>
+class Vec2Scaled : public Vec2Expr<Vec2Scaled<E>> {
+private:
+    Vec2Operand<E> inner;
+    double factor;
+
+public:
+    Vec2Scaled(const E& e, double s) : inner(e), factor(s) {}
+    double x(size_t i) const { return inner.x(i) * factor; }
+    double y(size_t i) const { return inner.y(i) * factor; }
+    size_t size() const { return inner.size(); }
+};
+
+// The operators only build nodes - no loops here
+template<typename L, typename R>
+Vec2Sum<L, R> operator+(const Vec2Expr<L>& l, const Vec2Expr<R>& r) {
+    return Vec2Sum<L, R>(l.self(), r.self());
+}
+
+template<typename L, typename R>
+Vec2Difference<L, R> operator-(const Vec2Expr<L>& l, const Vec2Expr<R>& r) {
+    return Vec2Difference<L, R>(l.self(), r.self());
+}
+
+template<typename E>
+Vec2Scaled<E> operator*(const Vec2Expr<E>& e, double scalar) {
+    return Vec2Scaled<E>(e.self(), scalar);
+}
+
+template<typename E>
+Vec2Scaled<E> operator*(double scalar, const Vec2Expr<E>& e) {
+    return Vec2Scaled<E>(e.self(), scalar);
+}
+
+class Vec2Array : public Vec2Expr<Vec2Array> {
+private:
+    vector<double> xs;  // All x components, contiguous
+    vector<double> ys;  // All y components, contiguous
+
+    // The one loop that evaluates any expression. Everything above is
+    // inlined into it, so 'a + b * s' becomes x[i] = a.x[i] + b.x[i] * s.
+    template<typename E>
+    void assign(const Vec2Expr<E>& expr) {
+        const E& e = expr.self();
+        const size_t n = e.size();
+        xs.resize(n);
+        ys.resize(n);
+        double* out_x = xs.data();
+        double* out_y = ys.data();
+        for (size_t i = 0; i < n; ++i) out_x[i] = e.x(i);
+        for (size_t i = 0; i < n; ++i) out_y[i] = e.y(i);
+    }
+
+public:
+    explicit Vec2Array(size_t count = 0) : xs(count, 0.0), ys(count, 0.0) {}
+
+    // Evaluating an expression creates a new array in a single pass
+    template<typename E>
+    Vec2Array(const Vec2Expr<E>& expr) { assign(expr); }
+
+    template<typename E>
+    Vec2Array& operator=(const Vec2Expr<E>& expr) {
+        // Safe even if the expression reads this array: element i is
+        // read before it is written, and never read again
+        assign(expr);
+        return *this;
+    }
+
+    template<typename E>
+    Vec2Array& operator+=(const Vec2Expr<E>& expr) {
+        const E& e = expr.self();
+        if (e.size() != size()) throw invalid_argument("Vec2Array sizes differ");
+        const size_t n = size();
+        double* out_x = xs.data();
+        double* out_y = ys.data();
+        for (size_t i = 0; i < n; ++i) out_x[i] += e.x(i);
+        for (size_t i = 0; i < n; ++i) out_y[i] += e.y(i);
+        return *this;
+    }
+
+    size_t size() const { return xs.size(); }
+    double x(size_t i) const { return xs[i]; }
+    double y(size_t i) const { return ys[i]; }
+
+    // Element access converts to/from the familiar Vector2D
+    Vector2D get(size_t i) const { return Vector2D(xs[i], ys[i]); }
+    void set(size_t i, const Vector2D& v) {
+        xs[i] = v.get_x();
+        ys[i] = v.get_y();
+    }
+    void push_back(const Vector2D& v) {
+        xs.push_back(v.get_x());
+        ys.push_back(v.get_y());
+    }
+
+    // ---- Whole-array kernels: simple loops over contiguous doubles ----
+
+    void scale(double factor) {
+        for (double& value : xs) value *= factor;
+        for (double& value : ys) value *= factor;
+    }
+
+    // out[i] = this[i] · other[i]
+    void dot(const Vec2Array& other, vector<double>& out) const {
+        if (other.size() != size()) throw invalid_argument("Vec2Array sizes differ");
+        out.resize(size());
+        for (size_t i = 0; i < size(); ++i) {
+            out[i] = xs[i] * other.xs[i] + ys[i] * other.ys[i];
+        }
+    }
+
+    // Sum of all element dot products (e.g. total kinetic energy)
+    double dot_total(const Vec2Array& other) const {
+        if (other.size() != size()) throw invalid_argument("Vec2Array sizes differ");
+        double total[4] = {0.0, 0.0, 0.0, 0.0};  // Independent sums -> SIMD friendly
+        size_t i = 0;
+        for (; i + 4 <= size(); i += 4) {
+            for (size_t lane = 0; lane < 4; ++lane) {
+                total[lane] += xs[i + lane] * other.xs[i + lane] + ys[i + lane] * other.ys[i + lane];
+            }
+        }
+        double result = (total[0] + total[1]) + (total[2] + total[3]);
+        for (; i < size(); ++i) result += xs[i] * other.xs[i] + ys[i] * other.ys[i];
+        return result;
+    }
+
+    void magnitudes(vector<double>& out) const {
+        out.resize(size());
+        for (size_t i = 0; i < size(); ++i) {
+            out[i] = sqrt(xs[i] * xs[i] + ys[i] * ys[i]);
+        }
+    }
+
+    // Same rule as Vector2D::normalize(): zero vectors stay (0, 0).
+    // Written with a select instead of an early return so it vectorizes.
+    void normalize() {
+        for (size_t i = 0; i < size(); ++i) {
+            double mag = sqrt(xs[i] * xs[i] + ys[i] * ys[i]);
+            double inverse = mag > 0.0 ? 1.0 / mag : 0.0;
+            xs[i] *= inverse;
+            ys[i] *= inverse;
+        }
+    }
+};
+
+void vec2_array_demo() {
+    cout << "\n=== Problem 2.2 (Extension): Vec2Array and Expression Templates ===\n\n";
+
+    Vec2Array a(3), b(3);
+    a.set(0, Vector2D(3.0, 4.0));
+    a.set(1, Vector2D(1.0, 2.0));
+    a.set(2, Vector2D(0.0, 0.0));
+    b.set(0, Vector2D(1.0, 1.0));
+    b.set(1, Vector2D(-1.0, 0.5));
+    b.set(2, Vector2D(2.0, 2.0));
+
+    // One fused loop: c[i] = a[i] + b[i] * 2
+    Vec2Array c = a + b * 2.0;
+    cout << "a + b * 2:\n";
+    for (size_t i = 0; i < c.size(); ++i) {
+        cout << "  " << a.get(i) << " + " << b.get(i) << " * 2 = " << c.get(i)
+             << "   (Vector2D gives " << a.get(i) + b.get(i) * 2.0 << ")\n";
+    }
+
+    vector<double> dots, lengths;
+    a.dot(b, dots);
+    a.magnitudes(lengths);
+    cout << "a[i] · b[i]: " << dots[0] << ", " << dots[1] << ", " << dots[2] << "\n";
+    cout << "|a[i]|:      " << lengths[0] << ", " << lengths[1] << ", " << lengths[2] << "\n";
+    a.normalize();
+    cout << "a normalized: " << a.get(0) << ", " << a.get(1) << ", " << a.get(2) << "\n";
+
+    // Particle update benchmark: position += velocity * dt, many frames
+    const size_t count = 1000000;
+    const int frames = 20;
+    const double dt = 0.016;
+
+    vector<Vector2D> aos_position(count), aos_velocity(count);
+    Vec2Array position(count), velocity(count);
+    for (size_t i = 0; i < count; ++i) {
+        Vector2D v(static_cast<double>(i % 100) * 0.01, static_cast<double>(i % 37) * 0.02);
+        aos_velocity[i] = v;
+        velocity.set(i, v);
+    }
+
+    using clock = chrono::steady_clock;
+    auto to_ms = [](clock::duration d) { return chrono::duration<double, milli>(d).count(); };
+
+    auto start = clock::now();
+    for (int f = 0; f < frames; ++f) {
+        for (size_t i = 0; i < count; ++i) {
+            aos_position[i] = aos_position[i] + aos_velocity[i] * dt;  // Temporaries per element
+        }
+    }
+    auto aos_time = clock::now() - start;
+
+    Vec2Array two_pass(count);
+    start = clock::now();
+    for (int f = 0; f < frames; ++f) {
+        Vec2Array step = velocity;  // Pass 1: temporary array
+        step.scale(dt);
+        two_pass += step;           // Pass 2: add it
+    }
+    auto two_pass_time = clock::now() - start;
+
+    start = clock::now();
+    for (int f = 0; f < frames; ++f) {
+        position += velocity * dt;  // One fused loop, no temporary array
+    }
+    auto fused_time = clock::now() - start;
+
+    cout << "\nUpdating " << count << " particles for " << frames << " frames:\n";
+    cout << "  vector<Vector2D>:             " << to_ms(aos_time) << " ms\n";
+    cout << "  Vec2Array, temporary + add:   " << to_ms(two_pass_time) << " ms\n";
+    cout << "  Vec2Array, fused expression:  " << to_ms(fused_time) << " ms\n";
+    cout << "  (last particle: " << aos_position[count - 1] << " vs " << position.get(count - 1) << ")\n";
+    cout << "The per-element Vector2D temporaries are free once inlined, so the first\n"
+         << "and last rows are both limited by memory speed. Whole-array temporaries\n"
+         << "are what cost: an extra pass plus a fresh 16 MB allocation every frame.\n";
+
+    cout << "\nKey Points:\n";
+    cout << "1. Structure of arrays keeps each component contiguous for SIMD loops\n";
+    cout << "2. Expression templates make operators return descriptions, not results\n";
+    cout << "3. The whole expression is evaluated in one loop, without temporaries\n";
+    cout << "4. Keep Vector2D for single values; use Vec2Array for bulk data\n";
+}
+
+// -----------------------------------------------------------------------------
+// Problem 2.2 (Extension 2): Spatial Index for Nearest-Neighbor Queries
+// -----------------------------------------------------------------------------
+// "Which point is closest to q?" with only Vector2D means computing
+// (p - q).magnitude() for EVERY point: 10 million points = 10 million
+// distances per query. A spatial index sorts the points by location once,
+// so a query only looks at points that could possibly be close.
+//
+// Two classic indexes:
+// - KdTree2D: splits the points in half again and again, alternating
+//   between x and y. Works for any point distribution.
+// - UniformGrid2D: chops the plane into equal square cells. Very fast when
+//   the points are spread evenly and the query radius is about one cell.
+//
+// Both compare SQUARED distances internally (no sqrt in the inner loop) and
+// store plain {x, y, id} records in one contiguous array - no pointers.
+
+struct Neighbor {
+    size_t id;        // Position of the point in the input (or insert order)
+    double distance;
+};
+
+struct IndexedPoint {
+    double x, y;
+    size_t id;
+};
+
+// Keeps the k closest candidates seen so far in a max-heap on distance,
+// so the current k-th best (the pruning radius) is always at the front
+class KBest {
+private:
+    size_t k;
+    vector<pair<double, size_t>> heap;  // (squared distance, id)
+
+public:
+    explicit KBest(size_t count) : k(count) { heap.reserve(count); }
+
+    double worst() const {
+        return heap.size() < k ? INFINITY : heap.front().first;
+    }
+
+    void offer(const IndexedPoint& p, double d2) {
+        if (heap.size() < k) {
+            heap.emplace_back(d2, p.id);
+            push_heap(heap.begin(), heap.end());
+        } else if (d2 < heap.front().first) {
+            pop_heap(heap.begin(), heap.end());
+            heap.back() = make_pair(d2, p.id);
+            push_heap(heap.begin(), heap.end());
+        }
+    }
+
+    vector<Neighbor> sorted() const {
+        vector<pair<double, size_t>> items = heap;
+        sort(items.begin(), items.end());
+        vector<Neighbor> result;
+        result.reserve(items.size());
+        for (const auto& item : items) result.push_back(Neighbor{item.second, sqrt(item.first)});
+        return result;
+    }
+};
+
+// Collects every point within a fixed radius
+class RadiusCollector {
+private:
+    double radius2;
+    vector<size_t>& found;
+
+public:
+    RadiusCollector(double radius, vector<size_t>& out) : radius2(radius * radius), found(out) {}
+    double worst() const { return radius2; }
+    void offer(const IndexedPoint& p, double d2) {
+        if (d2 <= radius2) found.push_back(p.id);
+    }
+};
+
+inline double distance2(const IndexedPoint& p, double qx, double qy) {
+    double dx = p.x - qx;
+    double dy = p.y - qy;
+    return dx * dx + dy * dy;
+}
+
+class KdTree2D {
+private:
+    static constexpr size_t leaf_size = 8;       // Small ranges are just scanned
+    static constexpr size_t pending_limit = 64;  // Inserts collected before building a tree
+
+    // IMPLICIT trees: no node objects, no child pointers. The subtree for the
+    // index range [lo, hi) has its splitting point at mid = (lo + hi) / 2;
+    // everything in [lo, mid) is on the low side of that split, everything
+    // in (mid, hi) on the high side. The split axis alternates x, y, x, ...
+    //
+    // A static tree cannot take new points, so the index is a FOREST of
+    // static trees, largest first, each less than half the size of the one
+    // before it - at most log2(n) trees. New points wait in 'pending' (a
+    // short list every query scans) and then become a small tree; equal-ish
+    // neighbours are merged into one bigger tree, like carries when adding
+    // 1 to a binary number.
+    vector<vector<IndexedPoint>> trees;
+    vector<IndexedPoint> pending;  // At most pending_limit points
+    size_t point_count = 0;
+    size_t next_id = 0;
+
+    static double coordinate(const IndexedPoint& p, int axis) {
+        return axis == 0 ? p.x : p.y;
+    }
+
+    static void build(vector<IndexedPoint>& tree, size_t lo, size_t hi, int axis) {
+        if (hi - lo <= leaf_size) return;
+        size_t mid = lo + (hi - lo) / 2;
+        // nth_element: median in place at mid, smaller ones before it - O(n)
+        nth_element(tree.begin() + lo, tree.begin() + mid, tree.begin() + hi,
+                    [axis](const IndexedPoint& a, const IndexedPoint& b) {
+                        return coordinate(a, axis) < coordinate(b, axis);
+                    });
+        build(tree, lo, mid, 1 - axis);
+        build(tree, mid + 1, hi, 1 - axis);
+    }
+
+    // Shared by all queries: 'visitor' decides what to keep (k best, or all
+    // within a radius) and reports how far away a useful point may still be
+    template<typename Visitor>
+    static void search(const vector<IndexedPoint>& tree, size_t lo, size_t hi, int axis,
+                       double qx, double qy, Visitor& visitor) {
+        if (hi - lo <= leaf_size) {
+            for (size_t i = lo; i < hi; ++i) visitor.offer(tree[i], distance2(tree[i], qx, qy));
+            return;
+        }
+        size_t mid = lo + (hi - lo) / 2;
+        const IndexedPoint& split = tree[mid];
+        visitor.offer(split, distance2(split, qx, qy));
+
+        double diff = (axis == 0 ? qx : qy) - coordinate(split, axis);
+        bool low_side_first = diff < 0;
+        if (low_side_first) search(tree, lo, mid, 1 - axis, qx, qy, visitor);
+        else                search(tree, mid + 1, hi, 1 - axis, qx, qy, visitor);
+
+        // The other side can only help if the splitting line is close enough
+        if (diff * diff <= visitor.worst()) {
+            if (low_side_first) search(tree, mid + 1, hi, 1 - axis, qx, qy, visitor);
+            else                search(tree, lo, mid, 1 - axis, qx, qy, visitor);
+        }
+    }
+
+    template<typename Visitor>
+    void query(double qx, double qy, Visitor& visitor) const {
+        for (const vector<IndexedPoint>& tree : trees) search(tree, 0, tree.size(), 0, qx, qy, visitor);
+        for (const IndexedPoint& p : pending) visitor.offer(p, distance2(p, qx, qy));
+    }
+
+    // Turns 'pending' into a tree, then merges the two smallest trees while
+    // the smaller one is at least half the size of the bigger one. Every
+    // point takes part in O(log n) rebuilds, so inserts cost O(log^2 n) on
+    // average, and a query visits at most log2(n) trees.
+    void flush_pending() {
+        trees.push_back(std::move(pending));
+        pending = vector<IndexedPoint>();
+        pending.reserve(pending_limit);
+        while (trees.size() >= 2 && trees[trees.size() - 2].size() <= 2 * trees.back().size()) {
+            vector<IndexedPoint>& bigger = trees[trees.size() - 2];
+            bigger.insert(bigger.end(), trees.back().begin(), trees.back().end());
+            trees.pop_back();
+        }
+        build(trees.back(), 0, trees.back().size(), 0);
+    }
+
+public:
+    KdTree2D() = default;
+
+    // Bulk build: O(n log n) once. Point i gets id i.
+    explicit KdTree2D(const vector<Vector2D>& points) {
+        vector<IndexedPoint> tree;
+        tree.reserve(points.size());
+        for (const Vector2D& p : points) tree.push_back(IndexedPoint{p.get_x(), p.get_y(), next_id++});
+        build(tree, 0, tree.size(), 0);
+        point_count = tree.size();
+        if (!tree.empty()) trees.push_back(std::move(tree));
+    }
+
+    // Incremental insert: new points wait in a short list (at most
+    // pending_limit) that every query scans, then join the forest above
+    size_t insert(const Vector2D& point) {
+        pending.push_back(IndexedPoint{point.get_x(), point.get_y(), next_id});
+        ++point_count;
+        if (pending.size() >= pending_limit) flush_pending();
+        return next_id++;
+    }
+
+    size_t size() const { return point_count; }
+
+    Neighbor nearest(const Vector2D& q) const {
+        if (size() == 0) throw logic_error("nearest() on an empty KdTree2D");
+        return k_nearest(q, 1).front();
+    }
+
+    // The k closest points, closest first
+    vector<Neighbor> k_nearest(const Vector2D& q, size_t k) const {
+        KBest best(k);
+        if (k > 0) query(q.get_x(), q.get_y(), best);
+        return best.sorted();
+    }
+
+    // Ids of all points with distance <= radius (in no particular order)
+    vector<size_t> within_radius(const Vector2D& q, double radius) const {
+        vector<size_t> found;
+        RadiusCollector collector(radius, found);
+        query(q.get_x(), q.get_y(), collector);
+        return found;
+    }
+};
+
+class UniformGrid2D {
+private:
+    double cell_size;
+    double min_x = 0.0, min_y = 0.0;
+    long cols = 1, rows = 1;
+    vector<size_t> cell_start;    // Points of cell c are points[cell_start[c] .. cell_start[c+1])
+    vector<IndexedPoint> points;  // Sorted by cell, so each cell is contiguous
+
+    long column_of(double x) const {
+        return max(0L, min(cols - 1, static_cast<long>((x - min_x) / cell_size)));
+    }
+    long row_of(double y) const {
+        return max(0L, min(rows - 1, static_cast<long>((y - min_y) / cell_size)));
+    }
+
+    template<typename Visitor>
+    void scan_cell(long col, long row, double qx, double qy, Visitor& visitor) const {
+        size_t cell = static_cast<size_t>(row * cols + col);
+        for (size_t i = cell_start[cell]; i < cell_start[cell + 1]; ++i) {
+            visitor.offer(points[i], distance2(points[i], qx, qy));
+        }
+    }
+
+public:
+    // Bulk build with a counting sort by cell: two linear passes, no tree
+    UniformGrid2D(const vector<Vector2D>& input, double cell) : cell_size(cell) {
+        if (cell <= 0.0) throw invalid_argument("cell size must be positive");
+        if (!input.empty()) {
+            double max_x = input[0].get_x(), max_y = input[0].get_y();
+            min_x = max_x;
+            min_y = max_y;
+            for (const Vector2D& p : input) {
+                min_x = min(min_x, p.get_x());
+                max_x = max(max_x, p.get_x());
+                min_y = min(min_y, p.get_y());
+                max_y = max(max_y, p.get_y());
+            }
+            cols = static_cast<long>((max_x - min_x) / cell_size) + 1;
+            rows = static_cast<long>((max_y - min_y) / cell_size) + 1;
+        }
+
+        // Count points per cell, turn counts into start offsets, then place
+        cell_start.assign(static_cast<size_t>(cols * rows) + 1, 0);
+        for (const Vector2D& p : input) {
+            ++cell_start[static_cast<size_t>(row_of(p.get_y()) * cols + column_of(p.get_x())) + 1];
+        }
+        for (size_t c = 1; c < cell_start.size(); ++c) cell_start[c] += cell_start[c - 1];
+
+        vector<size_t> fill(cell_start.begin(), cell_start.end() - 1);
+        points.resize(input.size());
+        for (size_t i = 0; i < input.size(); ++i) {
+            const Vector2D& p = input[i];
+            size_t cell = static_cast<size_t>(row_of(p.get_y()) * cols + column_of(p.get_x()));
+            points[fill[cell]++] = IndexedPoint{p.get_x(), p.get_y(), i};
+        }
+    }
+
+    size_t size() const { return points.size(); }
+
+    vector<size_t> within_radius(const Vector2D& q, double radius) const {
+        vector<size_t> found;
+        RadiusCollector collector(radius, found);
+        double qx = q.get_x(), qy = q.get_y();
+        for (long row = row_of(qy - radius); row <= row_of(qy + radius); ++row) {
+            for (long col = column_of(qx - radius); col <= column_of(qx + radius); ++col) {
+                scan_cell(col, row, qx, qy, collector);
+            }
+        }
+        return found;
+    }
+
+    // Searches rings of cells around the query cell until no unscanned
+    // cell can contain anything closer than the best point found so far
+    Neighbor nearest(const Vector2D& q) const {
+        if (points.empty()) throw logic_error("nearest() on an empty UniformGrid2D");
+        KBest best(1);
+        double qx = q.get_x(), qy = q.get_y();
+        long cx = column_of(qx), cy = row_of(qy);
+
+        for (long ring = 0; ; ++ring) {
+            for (long row = cy - ring; row <= cy + ring; ++row) {
+                if (row < 0 || row >= rows) continue;
+                bool edge_row = row == cy - ring || row == cy + ring;
+                long step = edge_row ? 1 : 2 * ring;  // Middle rows: only both ends
+                for (long col = cx - ring; col <= cx + ring; col += step) {
+                    if (col >= 0 && col < cols) scan_cell(col, row, qx, qy, best);
+                }
+            }
+
+            // Everything inside this rectangle has been scanned
+            double left = min_x + static_cast<double>(cx - ring) * cell_size;
+            double right = min_x + static_cast<double>(cx + ring + 1) * cell_size;
+            double bottom = min_y + static_cast<double>(cy - ring) * cell_size;
+            double top = min_y + static_cast<double>(cy + ring + 1) * cell_size;
+            double margin = min(min(qx - left, right - qx), min(qy - bottom, top - qy));
+            bool covers_grid = cx - ring <= 0 && cy - ring <= 0 &&
+                               cx + ring >= cols - 1 && cy + ring >= rows - 1;
+            if (covers_grid || (margin > 0 && margin * margin >= best.worst())) break;
+        }
+        return best.sorted().front();
+    }
+};
+
+// Batched queries: split the queries into one contiguous range per thread.
+// Each thread writes only its own part of 'results', so no locking needed.
+template<typename Index>
+void nearest_batch(const Index& index, const vector<Vector2D>& queries,
+                   vector<Neighbor>& results, unsigned thread_count = 0) {
+    if (thread_count == 0) thread_count = max(1u, thread::hardware_concurrency());
+    results.resize(queries.size());
+    size_t per_thread = (queries.size() + thread_count - 1) / thread_count;
+
+    auto work = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) results[i] = index.nearest(queries[i]);
+    };
+
+    vector<thread> workers;
+    for (unsigned t = 1; t < thread_count; ++t) {
+        size_t begin = min(queries.size(), t * per_thread);
+        size_t end = min(queries.size(), begin + per_thread);
+        if (begin < end) workers.emplace_back(work, begin, end);
+    }
+    work(0, min(queries.size(), per_thread));  // This thread takes the first range
+    for (thread& w : workers) w.join();
+}
+
+void spatial_index_demo() {
+    cout << "\n=== Problem 2.2 (Extension 2): Spatial Index ===\n\n";
+
+    vector<Vector2D> cities = {
+        Vector2D(0, 0), Vector2D(10, 0), Vector2D(0, 10), Vector2D(7, 7), Vector2D(3, 4)
+    };
+    KdTree2D small_tree(cities);
+    Vector2D here(6, 5);
+
+    Neighbor closest = small_tree.nearest(here);
+    cout << "Nearest to " << here << ": point " << closest.id << " " << cities[closest.id]
+         << " at distance " << closest.distance << "\n";
+
+    cout << "2 nearest:";
+    for (const Neighbor& n : small_tree.k_nearest(here, 2)) cout << " " << cities[n.id];
+    cout << "\n";
+
+    size_t id = small_tree.insert(Vector2D(6, 6));  // Incremental update
+    cout << "After inserting (6, 6) as point " << id << ", nearest is point "
+         << small_tree.nearest(here).id << "\n";
+    cout << "Points within 5 of " << here << ": " << small_tree.within_radius(here, 5.0).size() << "\n";
+
+    // Benchmark: random points, brute force vs. the two indexes
+    const size_t count = 1000000;
+    const size_t query_count = 2000;
+    const double extent = 1000.0;
+
+    vector<Vector2D> points(count);
+    vector<Vector2D> queries(query_count);
+    unsigned long long state = 12345;  // Small LCG: same points every run
+    auto next_random = [&state, extent]() {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        return static_cast<double>(state >> 11) / 9007199254740992.0 * extent;
+    };
+    for (Vector2D& p : points) p = Vector2D(next_random(), next_random());
+    for (Vector2D& q : queries) q = Vector2D(next_random(), next_random());
+
+    using clock = chrono::steady_clock;
+    auto to_ms = [](clock::duration d) { return chrono::duration<double, milli>(d).count(); };
+
+    auto start = clock::now();
+    KdTree2D tree(points);
+    auto tree_build = clock::now() - start;
+
+    start = clock::now();
+    UniformGrid2D grid(points, 2.0);  // About 4 points per cell
+    auto grid_build = clock::now() - start;
+
+    const size_t brute_count = 200;  // Brute force is too slow for all queries
+    start = clock::now();
+    vector<size_t> brute_ids(brute_count);
+    for (size_t qi = 0; qi < brute_count; ++qi) {
+        double best = INFINITY;
+        for (size_t i = 0; i < points.size(); ++i) {
+            double d = (points[i] - queries[qi]).magnitude();
+            if (d < best) {
+                best = d;
+                brute_ids[qi] = i;
+            }
+        }
+    }
+    auto brute_time = clock::now() - start;
+
+    vector<Neighbor> tree_results(query_count), grid_results(query_count);
+    start = clock::now();
+    for (size_t qi = 0; qi < query_count; ++qi) tree_results[qi] = tree.nearest(queries[qi]);
+    auto tree_time = clock::now() - start;
+
+    start = clock::now();
+    for (size_t qi = 0; qi < query_count; ++qi) grid_results[qi] = grid.nearest(queries[qi]);
+    auto grid_time = clock::now() - start;
+
+    vector<Neighbor> batch_results;
+    start = clock::now();
+    nearest_batch(tree, queries, batch_results);
+    auto batch_time = clock::now() - start;
+
+    size_t mismatches = 0;
+    for (size_t qi = 0; qi < query_count; ++qi) {
+        if (qi < brute_count && brute_ids[qi] != tree_results[qi].id) ++mismatches;
+        if (grid_results[qi].id != tree_results[qi].id) ++mismatches;
+        if (batch_results[qi].id != tree_results[qi].id) ++mismatches;
+    }
+
+    cout << "\n" << count << " random points:\n";
+    cout << "  build: k-d tree " << to_ms(tree_build) << " ms, grid " << to_ms(grid_build) << " ms\n";
+    cout << "  brute force: " << to_ms(brute_time) / brute_count * 1000.0 << " us per query\n";
+    cout << "  k-d tree:    " << to_ms(tree_time) / query_count * 1000.0 << " us per query\n";
+    cout << "  grid:        " << to_ms(grid_time) / query_count * 1000.0 << " us per query\n";
+    cout << "  k-d tree, batched on " << max(1u, thread::hardware_concurrency()) << " thread(s): "
+         << to_ms(batch_time) / query_count * 1000.0 << " us per query\n";
+    cout << "  results that disagree: " << mismatches << "\n";
+
+    cout << "\nKey Points:\n";
+    cout << "1. An index pays a one-time build cost so each query skips most points\n";
+    cout << "2. Compare squared distances - sqrt() is only needed for the answer\n";
+    cout << "3. A flat array (implicit tree, sorted cells) beats pointer-based nodes\n";
+    cout << "4. Independent queries parallelize with no locking: one range per thread\n";
+}
+
 } // namespace problem_set_2
 
 // =============================================================================
@@ -514,6 +1517,164 @@ void counter_demo() {
     cout << "4. Postfix is less efficient due to copy\n";
 }
 
+// -----------------------------------------------------------------------------
+// Problem 3.1 (Extension): ShardedCounter - A Counter Many Threads Can Share
+// -----------------------------------------------------------------------------
+// Counter's ++ on a plain int is a data race when several threads use it.
+// The usual fix, std::atomic<int>, is correct but slow under contention:
+// every increment needs exclusive ownership of the ONE cache line holding
+// the value, so with 64 threads that line "ping-pongs" between cores.
+//
+// ShardedCounter splits the count into several slots. Each thread always
+// increments "its" slot, and a read adds all slots together. Increments
+// (very frequent) become cheap; reads (rare) do a little more work.
+//
+// Each slot is aligned to its own 64-byte cache line. Without alignas,
+// neighbouring slots would share a line and the threads would still fight
+// over it ("false sharing") even though they touch different variables.
+
+class ShardedCounter {
+private:
+    static constexpr size_t cache_line_size = 64;
+
+    struct alignas(cache_line_size) Slot {
+        atomic<long long> value{0};
+    };
+
+    unique_ptr<Slot[]> slots;
+    size_t slot_mask;  // slot count - 1 (slot count is a power of two)
+
+    // Cached total for approximate_value()
+    mutable atomic<long long> cached_total{0};
+    mutable atomic<long long> cached_at_ns{LLONG_MIN};
+
+    // Each thread gets a number once (0, 1, 2, ...) and keeps it
+    static size_t thread_number() {
+        static atomic<size_t> next_number{0};
+        thread_local size_t number = next_number.fetch_add(1, memory_order_relaxed);
+        return number;
+    }
+
+    atomic<long long>& my_slot() {
+        return slots[thread_number() & slot_mask].value;
+    }
+
+public:
+    // Default: one slot per hardware thread, rounded up to a power of two
+    explicit ShardedCounter(size_t slot_count = 0) {
+        if (slot_count == 0) slot_count = max(1u, thread::hardware_concurrency());
+        size_t rounded = 1;
+        while (rounded < slot_count) rounded *= 2;
+        slots.reset(new Slot[rounded]);
+        slot_mask = rounded - 1;
+    }
+
+    // Not copyable: copying a counter other threads are updating makes no sense
+    ShardedCounter(const ShardedCounter&) = delete;
+    ShardedCounter& operator=(const ShardedCounter&) = delete;
+
+    // 'relaxed': we only need the addition itself to be atomic, not any
+    // ordering with other memory - the cheapest atomic operation there is
+    ShardedCounter& operator++() {
+        my_slot().fetch_add(1, memory_order_relaxed);
+        return *this;
+    }
+
+    ShardedCounter& operator--() {
+        my_slot().fetch_sub(1, memory_order_relaxed);
+        return *this;
+    }
+
+    // Postfix returns nothing: "the old value" is meaningless while other
+    // threads are counting too, and computing it would cost a full read
+    void operator++(int) { ++*this; }
+    void operator--(int) { --*this; }
+
+    ShardedCounter& operator+=(long long amount) {
+        my_slot().fetch_add(amount, memory_order_relaxed);
+        return *this;
+    }
+
+    // Adds up all slots. Exact once the updating threads have finished
+    // (e.g. after join()). While they are still running it returns a value
+    // somewhere between the counts at the start and end of the call.
+    long long get_value() const {
+        long long total = 0;
+        for (size_t i = 0; i <= slot_mask; ++i) {
+            total += slots[i].value.load(memory_order_acquire);
+        }
+        return total;
+    }
+
+    // For dashboards and rate limits that read VERY often: returns a total
+    // at most 'max_age' old, recomputing it only when it has expired
+    long long approximate_value(chrono::nanoseconds max_age = chrono::milliseconds(1)) const {
+        long long now = chrono::duration_cast<chrono::nanoseconds>(
+                            chrono::steady_clock::now().time_since_epoch()).count();
+        long long cached_at = cached_at_ns.load(memory_order_acquire);
+        if (cached_at != LLONG_MIN && now - cached_at < max_age.count()) {
+            return cached_total.load(memory_order_relaxed);
+        }
+        long long total = get_value();
+        cached_total.store(total, memory_order_relaxed);
+        cached_at_ns.store(now, memory_order_release);
+        return total;
+    }
+
+    size_t slot_count() const { return slot_mask + 1; }
+};
+
+void sharded_counter_demo() {
+    cout << "\n=== Problem 3.1 (Extension): ShardedCounter ===\n\n";
+
+    ShardedCounter requests;
+    ++requests;
+    requests++;
+    --requests;
+    requests += 10;
+    cout << "After ++, ++, --, += 10: " << requests.get_value() << " (expected 11)\n";
+    cout << "Slots: " << requests.slot_count() << " x " << sizeof(atomic<long long>)
+         << "-byte counter, each padded to 64 bytes\n";
+
+    // Contention benchmark: several threads hammer the same counter
+    const int thread_count = max(4, static_cast<int>(thread::hardware_concurrency()));
+    const int increments = 2000000;
+
+    using clock = chrono::steady_clock;
+    auto to_ms = [](clock::duration d) { return chrono::duration<double, milli>(d).count(); };
+
+    auto run = [&](auto& counter) {
+        auto start = clock::now();
+        vector<thread> threads;
+        for (int t = 0; t < thread_count; ++t) {
+            threads.emplace_back([&counter, increments]() {
+                for (int i = 0; i < increments; ++i) ++counter;
+            });
+        }
+        for (thread& t : threads) t.join();
+        return clock::now() - start;
+    };
+
+    atomic<int> single{0};
+    auto atomic_time = run(single);
+
+    ShardedCounter sharded(static_cast<size_t>(thread_count));
+    auto sharded_time = run(sharded);
+
+    cout << "\n" << thread_count << " threads x " << increments << " increments ("
+         << thread::hardware_concurrency() << " hardware threads):\n";
+    cout << "  std::atomic<int>: " << to_ms(atomic_time) << " ms, total " << single.load() << "\n";
+    cout << "  ShardedCounter:   " << to_ms(sharded_time) << " ms, total " << sharded.get_value() << "\n";
+    cout << "  approximate_value(): " << sharded.approximate_value() << "\n";
+    cout << "(The gap grows with the number of cores; on one core there is no contention.)\n";
+
+    cout << "\nKey Points:\n";
+    cout << "1. A single shared atomic becomes a bottleneck when many cores write it\n";
+    cout << "2. Give each thread its own slot; combine the slots only when reading\n";
+    cout << "3. Pad slots to a cache line (alignas(64)) to avoid false sharing\n";
+    cout << "4. Operators can keep their familiar syntax with a concurrent meaning\n";
+}
+
 // -----------------------------------------------------------------------------
 // Problem 3.2: Design Challenge - When NOT to Overload
 // -----------------------------------------------------------------------------
@@ -752,10 +1913,14 @@ int main() {
 
     // Problem Set 2: Basic Operator Overloading
     problem_set_2::money_class_demo();
+    problem_set_2::money_codec_demo();
     problem_set_2::vector2d_demo();
+    problem_set_2::vec2_array_demo();
+    problem_set_2::spatial_index_demo();
 
     // Problem Set 3: Advanced Operators and Best Practices
     problem_set_3::counter_demo();
+    problem_set_3::sharded_counter_demo();
     problem_set_3::design_challenge_demo();
 
     cout << "\n============================================\n";
@@ -805,6 +1970,9 @@ KEY LEARNING POINTS FOR CHAPTER 7
    - Postfix (x++): return copy then increment
    - Postfix is less efficient due to copy
    - Dummy int parameter distinguishes postfix from prefix
+   - Shared counters: ++ on a plain int is a data race; std::atomic fixes
+     that, and a sharded, cache-line-padded counter (ShardedCounter) keeps
+     it fast when many threads increment at once
 
 7. MEMBER VS NON-MEMBER:
    - Member when left operand is your class (v * 2)
@@ -824,6 +1992,26 @@ KEY LEARNING POINTS FOR CHAPTER 7
    - Use const for operators that don't modify object
    - Be careful with floating-point comparisons (use epsilon)
    - Store money as integers (cents) to avoid floating-point errors
+   - Parse and format money as text directly (parse_money/format_money),
+     never through double; report errors like std::from_chars does
+
+10. OPERATORS FOR BULK DATA (EXPRESSION TEMPLATES):
+   - Returning a new object from every operator is fine for one Vector2D,
+     but on arrays each operator becomes a full pass plus a temporary array
+   - Expression templates return lightweight "recipe" objects instead and
+     evaluate the whole expression in a single loop on assignment
+   - Store bulk data as structure of arrays (x[] and y[]) so the compiler
+     can vectorize the loops
+   - Build with optimization to see the difference:
+       g++ -std=c++17 -O3 -fno-math-errno -pthread expressions_hints.cpp -o expressions_hints
+     (-fno-math-errno lets sqrt() in magnitude/normalize vectorize)
+
+11. SPATIAL INDEXES:
+   - Brute-force nearest neighbor is O(n) per query; an index makes it
+     roughly O(log n) (k-d tree) or O(1) per nearby cell (uniform grid)
+   - Prune with squared distances; take sqrt() only for the final answer
+   - Batched queries are independent - split them across threads
+   - The spatial index demo uses threads, so add -pthread when compiling
 
 This comprehensive hints file covers all major concepts from Chapter 7
 with complete, working, well-commented examples that students can learn from.
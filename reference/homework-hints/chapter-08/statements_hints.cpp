@@ -2,9 +2,42 @@
 #include <vector>
 #include <string>
 #include <fstream>
+#include <iomanip>
 #include <stdexcept>
 #include <algorithm>
+#include <array>
 #include <sstream>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cctype>
+#include <cerrno>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define FILE_PROCESSOR_HAS_MMAP 1
+#endif
 
 // =============================================================================
 // PROBLEM SET 1: CONTROL FLOW FUNDAMENTALS
@@ -222,6 +255,149 @@ void problem_2_1_exception_handling() {
 // Problem 2.2: File Processor with RAII
 // -----------------------------------------------------------------------------
 
+// -----------------------------------------------------------------------------
+// Problem 2.2 (Extension): Single-Pass File Statistics
+// -----------------------------------------------------------------------------
+// count_lines(), count_words() and count_characters() each rewind and read
+// the WHOLE file again, and get(ch) hands over one character per call.
+// For a multi-gigabyte log that is three slow passes. FileProcessor::analyze()
+// below computes all three numbers in ONE pass:
+//
+// 1. MappedFile (RAII again!) maps the file into memory with mmap(), so the
+//    bytes are read straight from the operating system's page cache without
+//    copying them into a stream buffer.
+// 2. text_scan::scan() classifies 8 bytes at a time using one 64-bit
+//    integer ("SWAR" - SIMD within a register): which bytes are whitespace,
+//    which are '\n', and where a word starts (non-space after space).
+// 3. Large files are split into chunks that worker threads scan in
+//    parallel. A chunk looks at the byte just before it, so a word that
+//    crosses a chunk boundary is still counted exactly once.
+
+struct FileStats {
+    long long lines = 0;       // Same rule as getline: a final line without '\n' counts
+    long long words = 0;       // Same rule as >>: runs of non-whitespace
+    long long characters = 0;  // Same as get(ch): every byte
+};
+
+namespace text_scan {
+
+constexpr uint64_t ONES = 0x0101010101010101ULL;   // 0x01 in every byte
+constexpr uint64_t HIGH = 0x8080808080808080ULL;   // Top bit of every byte
+constexpr uint64_t LOW7 = 0x7F7F7F7F7F7F7F7FULL;   // Lower 7 bits of every byte
+
+// The whitespace characters that >> skips: ' ', '\t', '\n', '\v', '\f', '\r'
+inline bool is_space(unsigned char c) {
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+// In the functions below every byte of the result is 0x80 ("yes") or 0x00.
+// They are careful never to carry or borrow from one byte into the next.
+
+// Bytes equal to c
+inline uint64_t bytes_equal(uint64_t chunk, unsigned char c) {
+    uint64_t diff = chunk ^ (ONES * c);  // Zero bytes where chunk == c
+    return ~(((diff & LOW7) + LOW7) | diff) & HIGH;
+}
+
+// Bytes whose lower 7 bits are <= limit
+inline uint64_t low7_at_most(uint64_t chunk, unsigned char limit) {
+    return ((ONES * (0x80 | limit)) - (chunk & LOW7)) & HIGH;
+}
+
+inline uint64_t whitespace_flags(uint64_t chunk) {
+    uint64_t control = low7_at_most(chunk, '\r') & ~low7_at_most(chunk, '\t' - 1);
+    // '& ~chunk' drops bytes >= 0x80, whose lower 7 bits might look like a space
+    return (control | bytes_equal(chunk, ' ')) & ~chunk & HIGH;
+}
+
+// Number of "yes" bytes: move the flags to the low bit of each byte, then
+// the multiplication adds all eight bytes up into the top byte
+inline long long count_flags(uint64_t flags) {
+    return static_cast<long long>(((flags >> 7) * ONES) >> 56);
+}
+
+struct Counts {
+    long long newlines = 0;
+    long long word_starts = 0;
+};
+
+// Scans [begin, end). 'previous_is_space' describes the byte before 'begin'
+// (true at the start of the file) and is updated for the next call.
+inline Counts scan(const char* begin, const char* end, bool& previous_is_space) {
+    Counts counts;
+    const char* p = begin;
+
+#if !defined(__BYTE_ORDER__) || __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    while (end - p >= 8) {
+        uint64_t chunk;
+        std::memcpy(&chunk, p, 8);  // The first byte lands in the lowest 8 bits
+
+        uint64_t space = whitespace_flags(chunk);
+        // Shifting by 8 moves each byte's flag onto the NEXT byte, giving
+        // "the byte before me is whitespace" for all eight bytes at once
+        uint64_t space_before = (space << 8) | (previous_is_space ? 0x80ULL : 0);
+        uint64_t word_start = ~space & HIGH & space_before;
+
+        counts.newlines += count_flags(bytes_equal(chunk, '\n'));
+        counts.word_starts += count_flags(word_start);
+        previous_is_space = (space >> 63) != 0;
+        p += 8;
+    }
+#endif
+
+    for (; p < end; ++p) {  // The last few bytes (or everything, on big-endian)
+        bool space = is_space(static_cast<unsigned char>(*p));
+        if (*p == '\n') ++counts.newlines;
+        if (!space && previous_is_space) ++counts.word_starts;
+        previous_is_space = space;
+    }
+    return counts;
+}
+
+}  // namespace text_scan
+
+// RAII wrapper for a read-only memory mapping. If mapping is not possible
+// (other platforms, empty files, special files) is_mapped() is false and
+// the caller falls back to normal reads.
+class MappedFile {
+private:
+    const char* bytes = nullptr;
+    size_t length = 0;
+
+public:
+    explicit MappedFile(const std::string& path) {
+#ifdef FILE_PROCESSOR_HAS_MMAP
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return;
+        struct stat info;
+        if (::fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0) {
+            void* address = ::mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if (address != MAP_FAILED) {
+                bytes = static_cast<const char*>(address);
+                length = static_cast<size_t>(info.st_size);
+                ::madvise(address, length, MADV_SEQUENTIAL);  // Hint: read ahead aggressively
+            }
+        }
+        ::close(fd);  // The mapping stays valid after closing the descriptor
+#else
+        (void)path;
+#endif
+    }
+
+    ~MappedFile() {
+#ifdef FILE_PROCESSOR_HAS_MMAP
+        if (bytes) ::munmap(const_cast<char*>(bytes), length);
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool is_mapped() const { return bytes != nullptr; }
+    const char* data() const { return bytes; }
+    size_t size() const { return length; }
+};
+
 class FileProcessor {
 private:
     std::ifstream file;
@@ -309,6 +485,71 @@ public:
 
         return count;
     }
+
+    // All three counts in a single pass (see "Single-Pass File Statistics"
+    // above). thread_count = 0 means one thread per hardware thread.
+    FileStats analyze(unsigned thread_count = 0) {
+        if (!file.is_open()) {
+            throw std::runtime_error("File is not open");
+        }
+
+        FileStats stats;
+        long long newlines = 0;
+        char last_byte = '\n';  // Treat an empty file as ending in '\n'
+
+        MappedFile mapping(filename);
+        if (mapping.is_mapped()) {
+            const char* data = mapping.data();
+            const size_t size = mapping.size();
+
+            // Small files are not worth starting threads for
+            const size_t min_chunk = size_t(4) << 20;  // 4 MB
+            if (thread_count == 0) thread_count = std::max(1u, std::thread::hardware_concurrency());
+            size_t chunks = std::max<size_t>(1, std::min<size_t>(thread_count, size / min_chunk));
+            size_t chunk_size = (size + chunks - 1) / chunks;
+
+            std::vector<text_scan::Counts> results(chunks);
+            auto scan_chunk = [&](size_t c) {
+                size_t begin = c * chunk_size;
+                size_t end = std::min(size, begin + chunk_size);
+                // Peek at the byte before the chunk: a word crossing the
+                // boundary is counted by the chunk where it starts
+                bool previous_is_space = begin == 0 ||
+                                         text_scan::is_space(static_cast<unsigned char>(data[begin - 1]));
+                results[c] = text_scan::scan(data + begin, data + end, previous_is_space);
+            };
+
+            std::vector<std::thread> workers;
+            for (size_t c = 1; c < chunks; ++c) workers.emplace_back(scan_chunk, c);
+            scan_chunk(0);  // This thread takes the first chunk
+            for (auto& worker : workers) worker.join();
+
+            for (const auto& counts : results) {
+                newlines += counts.newlines;
+                stats.words += counts.word_starts;
+            }
+            stats.characters = static_cast<long long>(size);
+            last_byte = data[size - 1];
+        } else {
+            // Fallback: one sequential pass in large blocks through the stream
+            file.clear();
+            file.seekg(0, std::ios::beg);
+            std::vector<char> buffer(size_t(1) << 20);
+            bool previous_is_space = true;
+            while (file.read(buffer.data(), static_cast<std::streamsize>(buffer.size())) || file.gcount() > 0) {
+                size_t got = static_cast<size_t>(file.gcount());
+                text_scan::Counts counts = text_scan::scan(buffer.data(), buffer.data() + got, previous_is_space);
+                newlines += counts.newlines;
+                stats.words += counts.word_starts;
+                stats.characters += static_cast<long long>(got);
+                last_byte = buffer[got - 1];
+            }
+        }
+
+        // getline also counts a last line that has no '\n' at the end
+        stats.lines = newlines + (last_byte != '\n' ? 1 : 0);
+        return stats;
+    }
 };
 
 // Test function that demonstrates RAII even with exceptions
@@ -323,6 +564,10 @@ void test_file_processing(const std::string& filename) {
         std::cout << "Words: " << processor.count_words() << "\n";
         std::cout << "Characters: " << processor.count_characters() << "\n";
 
+        FileStats stats = processor.analyze();  // Same numbers, one pass
+        std::cout << "analyze(): " << stats.lines << " lines, " << stats.words
+                  << " words, " << stats.characters << " characters\n";
+
         // Simulate an exception
         if (processor.count_lines() > 100) {
             throw std::runtime_error("File too large!");
@@ -336,6 +581,55 @@ void test_file_processing(const std::string& filename) {
     std::cout << "File processing complete (file automatically closed)\n";
 }
 
+// Compares the three separate passes with analyze() on a larger file
+void problem_2_2_file_statistics_benchmark() {
+    std::cout << "\n=== Problem 2.2 (Extension): Single-Pass File Statistics ===\n";
+
+    const std::string filename = "large_sample.txt";
+    {
+        std::ofstream out(filename);
+        const char* words[] = {"error", "request", "user=42", "latency", "ok", "GET", "/index.html", "200"};
+        for (int line = 0; line < 800000; ++line) {
+            for (int w = 0; w < 6; ++w) {
+                out << words[(line + w * 3) % 8] << (w % 3 == 2 ? "\t" : " ");
+            }
+            out << line << "\n";
+        }
+        out << "last line without newline";
+    }
+
+    using clock = std::chrono::steady_clock;
+    auto to_ms = [](clock::duration d) {
+        return std::chrono::duration<double, std::milli>(d).count();
+    };
+
+    try {
+        FileProcessor processor(filename);
+
+        auto start = clock::now();
+        int lines = processor.count_lines();
+        int words = processor.count_words();
+        int characters = processor.count_characters();
+        auto three_pass_time = clock::now() - start;
+
+        start = clock::now();
+        FileStats stats = processor.analyze();
+        auto single_pass_time = clock::now() - start;
+
+        std::cout << "Three passes:  " << lines << " lines, " << words << " words, "
+                  << characters << " characters in " << to_ms(three_pass_time) << " ms\n";
+        std::cout << "analyze():     " << stats.lines << " lines, " << stats.words << " words, "
+                  << stats.characters << " characters in " << to_ms(single_pass_time) << " ms\n";
+        std::cout << "Results match: "
+                  << (stats.lines == lines && stats.words == words && stats.characters == characters ? "yes" : "NO")
+                  << "\n";
+    } catch (const std::exception& e) {
+        std::cout << "Error: " << e.what() << "\n";
+    }
+
+    std::remove(filename.c_str());
+}
+
 // =============================================================================
 // PROBLEM SET 3: ADVANCED INTEGRATION PROJECT
 // =============================================================================
@@ -356,6 +650,155 @@ public:
         : std::invalid_argument(message) {}
 };
 
+// -----------------------------------------------------------------------------
+// Parse Results Without Exceptions
+// -----------------------------------------------------------------------------
+// Throwing is cheap to write but expensive to run: every throw allocates
+// the exception and unwinds the stack, which costs about a microsecond -
+// far more than parsing the line. For a file where many lines are bad,
+// loading spends most of its time on exceptions.
+//
+// So the parser RETURNS its errors instead: Expected<T> holds either a
+// value or a StudentParseError (the idea of C++23's std::expected).
+// The exception-based functions (from_string, parse_into) still exist;
+// they call the same parser and only throw at the very end.
+
+struct StudentParseError {
+    enum Code {
+        None,
+        InvalidId,        // std::stoi would throw std::invalid_argument
+        IdOutOfRange,     // std::stoi would throw std::out_of_range
+        InvalidGrade,     // std::stod would throw std::invalid_argument
+        GradeOutOfRange,  // std::stod would throw std::out_of_range
+        GradeNotAllowed   // Not between 0 and 100 (InvalidGradeException)
+    };
+
+    Code code = None;
+    size_t column = 0;  // Where the bad field starts in the line (0-based)
+
+    bool ok() const { return code == None; }
+
+    const char* message() const {
+        switch (code) {
+            case None:            return "ok";
+            case InvalidId:       return "invalid student ID";
+            case IdOutOfRange:    return "student ID out of range";
+            case InvalidGrade:    return "invalid grade";
+            case GradeOutOfRange: return "grade out of range";
+            case GradeNotAllowed: return "grade not between 0 and 100";
+        }
+        return "unknown error";
+    }
+
+    // Throws what the original exception-based parser threw for this error
+    // ("stoi"/"stod" are the messages of the standard library's exceptions)
+    [[noreturn]] void raise() const {
+        switch (code) {
+            case None:            break;
+            case InvalidId:       throw std::invalid_argument("stoi");
+            case IdOutOfRange:    throw std::out_of_range("stoi");
+            case InvalidGrade:    throw std::invalid_argument("stod");
+            case GradeOutOfRange: throw std::out_of_range("stod");
+            case GradeNotAllowed: throw InvalidGradeException("Grade must be between 0 and 100");
+        }
+        throw std::logic_error("raise() called without an error");
+    }
+};
+
+template<typename T>
+class Expected {
+private:
+    T stored_value{};
+    StudentParseError stored_error;
+
+public:
+    Expected(T value) : stored_value(value) {}
+    Expected(StudentParseError error) : stored_error(error) {}
+
+    bool has_value() const { return stored_error.ok(); }
+    explicit operator bool() const { return has_value(); }
+    const T& value() const { return stored_value; }  // Only if has_value()
+    const StudentParseError& error() const { return stored_error; }
+};
+
+// One bad line found while loading a file
+struct LineDiagnostic {
+    size_t line_number;         // 1-based line in the file
+    StudentParseError error;
+    std::string text;           // The line (at most 80 characters of it)
+};
+
+// -----------------------------------------------------------------------------
+// Grade Points
+// -----------------------------------------------------------------------------
+// 90-100 = 4.0, 80-89 = 3.0, 70-79 = 2.0, 60-69 = 1.0, <60 = 0.0
+// All limits are whole numbers, so a grade of 89.5 gets the points of 89:
+// a table with one entry per whole grade replaces the if-else chain.
+// The table is computed by the COMPILER (constexpr) - at run time it is
+// just 101 bytes of data.
+
+namespace grade_points {
+
+constexpr unsigned char points_for_whole_grade(int grade) {
+    return grade >= 90 ? 4 : grade >= 80 ? 3 : grade >= 70 ? 2 : grade >= 60 ? 1 : 0;
+}
+
+constexpr std::array<unsigned char, 101> make_table() {
+    std::array<unsigned char, 101> table{};
+    for (int grade = 0; grade <= 100; ++grade) {
+        table[grade] = points_for_whole_grade(grade);
+    }
+    return table;
+}
+
+constexpr std::array<unsigned char, 101> table = make_table();
+
+static_assert(table[59] == 0 && table[60] == 1 && table[89] == 3 && table[90] == 4 && table[100] == 4,
+              "grade point table does not match the grading scale");
+
+// 'grade' must already be validated (0-100). NaN passes validation (every
+// comparison with NaN is false) and, as in the if-else chain, earns 0.
+inline int for_grade(double grade) {
+    return table[grade >= 0.0 ? static_cast<int>(grade) : 0];
+}
+
+// Points of one grade without the table and without branches: each
+// comparison is 0 or 1
+inline double branchless_points(double grade) {
+    return (grade >= 60.0 ? 1.0 : 0.0) + (grade >= 70.0 ? 1.0 : 0.0) +
+           (grade >= 80.0 ? 1.0 : 0.0) + (grade >= 90.0 ? 1.0 : 0.0);
+}
+
+// Total points for many grades at once. Four independent running sums
+// ("lanes") let the compiler handle several grades per instruction (SIMD,
+// with -O3). The sums are whole numbers, so adding them as doubles is exact.
+// Gives the same result as summing for_grade().
+inline long long total(const double* grades, size_t count) {
+    double lanes[4] = {0.0, 0.0, 0.0, 0.0};
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        for (size_t lane = 0; lane < 4; ++lane) {
+            lanes[lane] += branchless_points(grades[i + lane]);
+        }
+    }
+    double sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    for (; i < count; ++i) {
+        sum += branchless_points(grades[i]);
+    }
+    return static_cast<long long>(sum);
+}
+
+// Number of grades outside 0-100 (branch-free, like total())
+inline size_t count_invalid(const double* grades, size_t count) {
+    size_t invalid = 0;
+    for (size_t i = 0; i < count; ++i) {
+        invalid += (grades[i] < 0.0) | (grades[i] > 100.0);
+    }
+    return invalid;
+}
+
+}  // namespace grade_points
+
 // -----------------------------------------------------------------------------
 // Student Class
 // -----------------------------------------------------------------------------
@@ -365,6 +808,7 @@ private:
     int id;
     std::string name;
     std::vector<double> grades;
+    long long point_sum = 0;  // Sum of the points of all grades, kept up to date
 
 public:
     // Constructors
@@ -382,26 +826,27 @@ public:
             throw InvalidGradeException("Grade must be between 0 and 100");
         }
         grades.push_back(grade);
+        point_sum += grade_points::for_grade(grade);
+    }
+
+    // Add many grades at once (bulk import). All or nothing: if any grade
+    // is invalid, none are added.
+    void add_grades(const double* new_grades, size_t count) {
+        if (grade_points::count_invalid(new_grades, count) > 0) {
+            throw InvalidGradeException("Grade must be between 0 and 100");
+        }
+        grades.insert(grades.end(), new_grades, new_grades + count);
+        point_sum += grade_points::total(new_grades, count);
     }
 
     // Calculate GPA (on 4.0 scale)
+    // The point sum is updated whenever a grade is added, so this is O(1)
+    // instead of a walk over all grades on every call.
     double calculate_gpa() const {
         if (grades.empty()) {
             return 0.0;
         }
-
-        double sum = 0.0;
-        for (const auto& grade : grades) {
-            // Convert percentage to 4.0 scale
-            // 90-100 = 4.0, 80-89 = 3.0, 70-79 = 2.0, 60-69 = 1.0, <60 = 0.0
-            if (grade >= 90) sum += 4.0;
-            else if (grade >= 80) sum += 3.0;
-            else if (grade >= 70) sum += 2.0;
-            else if (grade >= 60) sum += 1.0;
-            else sum += 0.0;
-        }
-
-        return sum / grades.size();
+        return static_cast<double>(point_sum) / grades.size();
     }
 
     // Display student information
@@ -419,38 +864,311 @@ public:
         std::cout << ", GPA: " << calculate_gpa() << "\n";
     }
 
-    // Serialization for file I/O
+    // Serialization for file I/O: "id,name,grade,grade,..."
+    // -------------------------------------------------------------------------
+    // The codec below avoids string streams: building an ostringstream or
+    // istringstream per line (plus a token string per field) costs far more
+    // than the actual number conversions. std::to_chars/std::from_chars
+    // convert numbers directly in a char buffer - no locale, no allocation.
+
+    // Upper bound on the number of characters serialize_to() writes
+    size_t serialized_size_bound() const {
+        return 12 + name.size() + grades.size() * 32;
+    }
+
+    // Writes this student's line into [first, last) without allocating.
+    // Grades are written in the shortest form that reads back as exactly
+    // the same double (std::to_chars without a precision), like the
+    // journal does. For grades with up to 6 significant digits this is
+    // byte-for-byte what 'ostream << double' (%g, precision 6) produced;
+    // longer ones (89.9999999) are no longer rounded to 90, so a grade and
+    // its GPA points are the same after a compaction as after a replay.
+    std::to_chars_result serialize_to(char* first, char* last) const {
+        std::to_chars_result result = std::to_chars(first, last, id);
+        if (result.ec != std::errc()) return result;
+        char* p = result.ptr;
+
+        if (static_cast<size_t>(last - p) < name.size() + 1) {
+            return {last, std::errc::value_too_large};
+        }
+        *p++ = ',';
+        std::memcpy(p, name.data(), name.size());
+        p += name.size();
+
+        for (double grade : grades) {
+            if (p == last) return {last, std::errc::value_too_large};
+            *p++ = ',';
+            result = std::to_chars(p, last, grade);
+            if (result.ec != std::errc()) return result;
+            p = result.ptr;
+        }
+        return {p, std::errc()};
+    }
+
     std::string to_string() const {
-        std::ostringstream oss;
-        oss << id << "," << name;
-        for (const auto& grade : grades) {
-            oss << "," << grade;
+        std::string line(serialized_size_bound(), '\0');
+        std::to_chars_result result = serialize_to(&line[0], &line[0] + line.size());
+        line.resize(static_cast<size_t>(result.ptr - line.data()));
+        return line;
+    }
+
+private:
+    static StudentParseError parse_error(StudentParseError::Code code, size_t column) {
+        StudentParseError error;
+        error.code = code;
+        error.column = column;
+        return error;
+    }
+
+    // Same result as std::stoi(token), without exceptions. The common case
+    // goes through from_chars. Leading spaces and '+' (which from_chars
+    // does not accept) go through strtol, the function stoi itself uses.
+    static Expected<int> try_parse_id(std::string_view token, size_t column) {
+        if (!token.empty() && token[0] != '+' && !std::isspace(static_cast<unsigned char>(token[0]))) {
+            int value = 0;
+            std::from_chars_result result = std::from_chars(token.data(), token.data() + token.size(), value);
+            if (result.ec == std::errc()) return value;
+            return parse_error(result.ec == std::errc::result_out_of_range ? StudentParseError::IdOutOfRange
+                                                                           : StudentParseError::InvalidId,
+                               column);
+        }
+        std::string text(token);  // strtol needs a '\0' at the end
+        char* end = nullptr;
+        errno = 0;
+        long value = std::strtol(text.c_str(), &end, 10);
+        if (end == text.c_str()) return parse_error(StudentParseError::InvalidId, column);
+        if (errno == ERANGE || value < std::numeric_limits<int>::min() || value > std::numeric_limits<int>::max()) {
+            return parse_error(StudentParseError::IdOutOfRange, column);
+        }
+        return static_cast<int>(value);
+    }
+
+    // Same result as std::stod(token), without exceptions. Cases stod
+    // treats differently from from_chars go through strtod (which stod
+    // uses): leading spaces, '+', hexadecimal input ("0x1p3") and tiny
+    // subnormal values (stod reports those as out of range).
+    static Expected<double> try_parse_grade(std::string_view token, size_t column) {
+        if (!token.empty() && token[0] != '+' && !std::isspace(static_cast<unsigned char>(token[0]))) {
+            double value = 0.0;
+            const char* last = token.data() + token.size();
+            std::from_chars_result result = std::from_chars(token.data(), last, value);
+            bool hexadecimal = result.ptr < last && (*result.ptr == 'x' || *result.ptr == 'X');
+            bool subnormal = std::fpclassify(value) == FP_SUBNORMAL;
+            if (result.ec == std::errc() && !hexadecimal && !subnormal) return value;
+        }
+        std::string text(token);
+        char* end = nullptr;
+        errno = 0;
+        double value = std::strtod(text.c_str(), &end);
+        if (end == text.c_str()) return parse_error(StudentParseError::InvalidGrade, column);
+        if (errno == ERANGE) return parse_error(StudentParseError::GradeOutOfRange, column);
+        return value;
+    }
+
+public:
+    // Parses "id,name,grade,..." into 'student', reusing the memory its
+    // name and grade vector already own. Never throws (except bad_alloc):
+    // problems are returned, and accept/reject decisions are identical to
+    // the original stream version. On error 'student' is partially filled.
+    static StudentParseError try_parse_into(std::string_view line, Student& student) {
+        size_t comma = line.find(',');
+        Expected<int> id = try_parse_id(line.substr(0, comma), 0);
+        if (!id) return id.error();
+        student.id = id.value();
+        student.name.clear();
+        student.grades.clear();
+        student.point_sum = 0;
+        if (comma == std::string_view::npos) return StudentParseError();
+
+        size_t pos = comma + 1;
+        size_t name_end = line.find(',', pos);
+        student.name.assign(line.substr(pos, name_end == std::string_view::npos ? std::string_view::npos
+                                                                                : name_end - pos));
+        if (name_end == std::string_view::npos) return StudentParseError();
+
+        // Like getline: a trailing ',' does not produce an empty grade,
+        // but an empty field in the middle does (and fails to parse)
+        pos = name_end + 1;
+        while (pos < line.size()) {
+            size_t grade_end = line.find(',', pos);
+            if (grade_end == std::string_view::npos) grade_end = line.size();
+            Expected<double> grade = try_parse_grade(line.substr(pos, grade_end - pos), pos);
+            if (!grade) return grade.error();
+            if (grade.value() < 0.0 || grade.value() > 100.0) {  // Same check as add_grade()
+                return parse_error(StudentParseError::GradeNotAllowed, pos);
+            }
+            student.grades.push_back(grade.value());
+            student.point_sum += grade_points::for_grade(grade.value());
+            pos = grade_end + 1;
         }
-        return oss.str();
+        return StudentParseError();
+    }
+
+    // Exception-based version: throws the same std::invalid_argument /
+    // std::out_of_range / InvalidGradeException as the original code.
+    // If it throws, 'student' is left partially filled.
+    static void parse_into(std::string_view line, Student& student) {
+        StudentParseError error = try_parse_into(line, student);
+        if (!error.ok()) error.raise();
     }
 
     // Deserialization from file
     static Student from_string(const std::string& str) {
-        std::istringstream iss(str);
-        std::string token;
+        Student student(0, "");
+        parse_into(str, student);
+        return student;
+    }
+};
+
+// -----------------------------------------------------------------------------
+// Indexed Student File (lazy loading)
+// -----------------------------------------------------------------------------
+// Loading every student at startup takes time proportional to the file
+// size, even if the session then looks at only a few students. So the file
+// can end with an INDEX: one line per student telling where its record is.
+// The index lines start with '#', so load_students() (which skips comment
+// lines) still reads such a file normally.
+//
+//     #seq 12                      <- optional, see save_students()
+//     1001,Alice,95,88             <- the records, as always
+//     1002,Bob,72
+//     #index 2
+//     #i 1001 8 16 3.5             <- id, byte offset, length, GPA
+//     #i 1002 25 11 2
+//     #index-start 37              <- where "#index" starts (last line)
+//
+// To open the file, read the last line, jump to the index and read only
+// the index. A record is read (and parsed) when it is first needed.
+// The GPA is in the index too, so rank queries work without any records.
+
+struct StudentIndexEntry {
+    int id;
+    double gpa;
+    uint64_t offset;  // Where the record starts in the file
+    uint32_t length;  // Record length without the '\n'
+};
 
-        // Read ID
-        std::getline(iss, token, ',');
-        int id = std::stoi(token);
+class IndexedStudentFile {
+private:
+    std::string filename;
+    MappedFile mapping;
+    mutable std::ifstream file;  // For reading records when not memory-mapped
+    std::vector<StudentIndexEntry> entries;
 
-        // Read name
-        std::string name;
-        std::getline(iss, name, ',');
+    static constexpr const char* start_marker = "#index-start ";
 
-        Student student(id, name);
+public:
+    // Reads the index; throws std::runtime_error if the file has none
+    explicit IndexedStudentFile(const std::string& path)
+        : filename(path), mapping(path), file(path, std::ios::binary) {
+        long long index_start = find_index(file);
+        if (index_start < 0) {
+            throw std::runtime_error("File has no index: " + path);
+        }
 
-        // Read grades
-        while (std::getline(iss, token, ',')) {
-            double grade = std::stod(token);
-            student.add_grade(grade);
+        file.clear();
+        file.seekg(index_start);
+        std::string line;
+        std::getline(file, line);  // "#index N"
+        if (line.compare(0, 7, "#index ") == 0) {
+            entries.reserve(static_cast<size_t>(std::strtoull(line.c_str() + 7, nullptr, 10)));
+        }
+        while (std::getline(file, line) && line.compare(0, 3, "#i ") == 0) {
+            StudentIndexEntry entry;
+            if (!parse_entry(line, entry)) {
+                throw std::runtime_error("Corrupt index in file: " + path);
+            }
+            entries.push_back(entry);
         }
+    }
 
-        return student;
+    IndexedStudentFile(const IndexedStudentFile&) = delete;
+    IndexedStudentFile& operator=(const IndexedStudentFile&) = delete;
+
+    static bool has_index(const std::string& path) {
+        std::ifstream in(path, std::ios::binary);
+        return find_index(in) >= 0;
+    }
+
+    size_t size() const { return entries.size(); }
+    const StudentIndexEntry& entry(size_t record) const { return entries[record]; }
+
+    // Reads and parses one record. Throws std::runtime_error if the record
+    // does not match its index entry (the file was changed by hand).
+    void read(size_t record, Student& student) const {
+        const StudentIndexEntry& e = entries[record];
+        std::string buffer;
+        std::string_view text;
+        if (mapping.is_mapped() && e.offset + e.length <= mapping.size()) {
+            text = std::string_view(mapping.data() + e.offset, e.length);
+        } else {
+            buffer.resize(e.length);
+            file.clear();
+            file.seekg(static_cast<std::streamoff>(e.offset));
+            file.read(&buffer[0], e.length);
+            buffer.resize(static_cast<size_t>(file.gcount()));
+            text = buffer;
+        }
+        if (!Student::try_parse_into(text, student).ok() || student.get_id() != e.id) {
+            throw std::runtime_error("Corrupt record for student ID " + std::to_string(e.id) + " in " + filename);
+        }
+    }
+
+    // Writes one "#i id offset length gpa\n" line (at most 64 characters)
+    // and returns the end. The GPA is written exactly (shortest round trip).
+    static char* format_entry(char* out, const StudentIndexEntry& e) {
+        char* end = out + 64;
+        std::memcpy(out, "#i ", 3);
+        out = std::to_chars(out + 3, end, e.id).ptr;
+        *out++ = ' ';
+        out = std::to_chars(out, end, e.offset).ptr;
+        *out++ = ' ';
+        out = std::to_chars(out, end, e.length).ptr;
+        *out++ = ' ';
+        out = std::to_chars(out, end, e.gpa).ptr;
+        *out++ = '\n';
+        return out;
+    }
+
+    static std::string format_index_end(uint64_t index_start) {
+        return start_marker + std::to_string(index_start) + "\n";
+    }
+
+private:
+    static bool parse_entry(const std::string& line, StudentIndexEntry& e) {
+        const char* p = line.data() + 3;
+        const char* end = line.data() + line.size();
+        std::from_chars_result r = std::from_chars(p, end, e.id);
+        if (r.ec != std::errc() || r.ptr == end) return false;
+        r = std::from_chars(r.ptr + 1, end, e.offset);
+        if (r.ec != std::errc() || r.ptr == end) return false;
+        r = std::from_chars(r.ptr + 1, end, e.length);
+        if (r.ec != std::errc() || r.ptr == end) return false;
+        r = std::from_chars(r.ptr + 1, end, e.gpa);
+        return r.ec == std::errc() && r.ptr == end;
+    }
+
+    // Offset of the "#index" line, from the "#index-start N" last line;
+    // -1 if the file has no index
+    static long long find_index(std::ifstream& in) {
+        if (!in.is_open()) return -1;
+        in.seekg(0, std::ios::end);
+        long long size = static_cast<long long>(in.tellg());
+        if (size <= 0) return -1;
+
+        long long tail_size = std::min<long long>(size, 48);
+        std::string tail(static_cast<size_t>(tail_size), '\0');
+        in.seekg(size - tail_size);
+        in.read(&tail[0], tail_size);
+        if (in.gcount() != tail_size || tail.back() != '\n') return -1;
+
+        size_t marker = tail.rfind(start_marker);
+        if (marker == std::string::npos || (marker > 0 && tail[marker - 1] != '\n')) return -1;
+        long long index_start = -1;
+        const char* first = tail.data() + marker + std::strlen(start_marker);
+        std::from_chars_result r = std::from_chars(first, tail.data() + tail.size() - 1, index_start);
+        if (r.ec != std::errc() || r.ptr != tail.data() + tail.size() - 1 || index_start >= size) return -1;
+        return index_start;
     }
 };
 
@@ -466,25 +1184,137 @@ public:
     StudentFileManager(const std::string& fname) : filename(fname) {}
 
     // Save students to file using RAII
-    void save_students(const std::vector<Student>& students) {
+    // The data goes to a temporary file first, which then replaces the old
+    // file in one step (rename) - a crash while saving never leaves a
+    // half-written roster behind. If snapshot_seq >= 0, the file starts with
+    // a "#seq N" line: it already contains journal records 1..N.
+    // With 'with_index' the file ends with an index for lazy loading
+    // (see IndexedStudentFile).
+    void save_students(const std::vector<Student>& students, long long snapshot_seq = -1,
+                       bool with_index = false) {
+        save_students_from([&students](auto&& emit) {
+            for (const Student& student : students) emit(student);
+        }, snapshot_seq, with_index);
+    }
+
+    // Streaming variant: produce(emit) calls emit(const Student&) once for
+    // every student, in file order, so the students never have to be in
+    // memory all at once (see StudentManagementSystem::start_compaction)
+    template<typename Producer>
+    void save_students_from(Producer&& produce, long long snapshot_seq = -1, bool with_index = false) {
+        const std::string temp_name = filename + ".tmp";
+        write_students(temp_name, produce, snapshot_seq, with_index);
+        if (std::rename(temp_name.c_str(), filename.c_str()) != 0) {
+            // Some platforms (Windows) refuse to rename onto an existing file
+            std::remove(filename.c_str());
+            if (std::rename(temp_name.c_str(), filename.c_str()) != 0) {
+                throw std::runtime_error("Failed to replace file: " + filename);
+            }
+        }
+    }
+
+    // The journal sequence number stored by save_students, or 0 if the file
+    // has none (or does not exist yet)
+    long long read_snapshot_seq() const {
+        std::ifstream file(filename);
+        std::string first_line;
+        if (!std::getline(file, first_line) || first_line.compare(0, 5, "#seq ") != 0) {
+            return 0;
+        }
+        long long seq = 0;
+        std::from_chars(first_line.data() + 5, first_line.data() + first_line.size(), seq);
+        return seq;
+    }
+
+    const std::string& get_filename() const { return filename; }
+
+private:
+    template<typename Producer>
+    static void write_students(const std::string& path, Producer& produce,
+                               long long snapshot_seq, bool with_index) {
         // RAII: ofstream automatically closes when it goes out of scope
-        std::ofstream file(filename);
+        // (binary: the index stores byte offsets, so no newline translation)
+        std::ofstream file(path, std::ios::binary);
 
         if (!file.is_open()) {
-            throw std::runtime_error("Failed to open file for writing: " + filename);
+            throw std::runtime_error("Failed to open file for writing: " + path);
+        }
+
+        // Lines are serialized into one buffer and written in large blocks
+        const size_t flush_size = size_t(1) << 20;
+        std::string buffer;
+        buffer.reserve(flush_size + 4096);
+        uint64_t written = 0;  // Bytes already passed to 'file'
+        auto flush_if_full = [&]() {
+            if (buffer.size() >= flush_size) {
+                file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+                written += buffer.size();
+                buffer.clear();
+            }
+        };
+
+        if (snapshot_seq >= 0) {
+            buffer += "#seq " + std::to_string(snapshot_seq) + "\n";
         }
 
-        for (const auto& student : students) {
-            file << student.to_string() << "\n";
+        std::vector<StudentIndexEntry> index;
+        Student written_back(0, "");  // The line as a reader will see it
+        produce([&](const Student& student) {
+            size_t start = buffer.size();
+            buffer.resize(start + student.serialized_size_bound() + 1);
+            char* end = student.serialize_to(&buffer[start], &buffer[0] + buffer.size()).ptr;
+            if (with_index) {
+                // The index GPA must match what loading this line gives, so
+                // it is computed from the text just written - not from the
+                // grades in memory, in case the text format ever rounds them
+                std::string_view line(&buffer[start], static_cast<size_t>(end - &buffer[start]));
+                double gpa = Student::try_parse_into(line, written_back).ok() ? written_back.calculate_gpa()
+                                                                              : student.calculate_gpa();
+                index.push_back({student.get_id(), gpa, written + start, static_cast<uint32_t>(line.size())});
+            }
+            *end++ = '\n';
+            buffer.resize(static_cast<size_t>(end - buffer.data()));
+            flush_if_full();
+        });
+
+        if (with_index) {
+            uint64_t index_start = written + buffer.size();
+            buffer += "#index " + std::to_string(index.size()) + "\n";
+            for (const StudentIndexEntry& entry : index) {
+                size_t start = buffer.size();
+                buffer.resize(start + 64);
+                char* end = IndexedStudentFile::format_entry(&buffer[start], entry);
+                buffer.resize(static_cast<size_t>(end - buffer.data()));
+                flush_if_full();
+            }
+            buffer += IndexedStudentFile::format_index_end(index_start);
+        }
+        file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        file.flush();
+        if (!file) {
+            throw std::runtime_error("Failed to write file: " + path);
         }
 
         // File automatically closed here when 'file' goes out of scope
     }
 
-    // Load students from file using RAII
-    std::vector<Student> load_students() {
-        std::vector<Student> students;
+public:
 
+    // Load students from file using RAII
+    // -------------------------------------------------------------------------
+    // Large rosters are loaded in parallel:
+    // 1. The file is memory-mapped (MappedFile, see Problem 2.2) or, if that
+    //    is not possible, read with one call.
+    // 2. The text is cut into chunks, always right after a '\n', so no line
+    //    is split between two chunks.
+    // 3. Worker threads take chunks one at a time and parse them into their
+    //    own vector - no locking while parsing.
+    // 4. The chunk results are joined in file order, and the problems found
+    //    in bad lines are collected in file order too.
+    // thread_count = 0 means one thread per hardware thread.
+    // Bad lines are skipped and described in 'diagnostics' (nothing is
+    // printed, and no exception is thrown for them).
+    std::vector<Student> load_students(std::vector<LineDiagnostic>& diagnostics, unsigned thread_count = 0) {
         // RAII: ifstream automatically closes when it goes out of scope
         std::ifstream file(filename);
 
@@ -492,58 +1322,1690 @@ public:
             throw std::runtime_error("Failed to open file for reading: " + filename);
         }
 
-        std::string line;
-        while (std::getline(file, line)) {
-            if (!line.empty()) {
-                try {
-                    students.push_back(Student::from_string(line));
-                } catch (const std::exception& e) {
-                    std::cerr << "Warning: Skipping invalid line: " << e.what() << "\n";
-                }
+        MappedFile mapping(filename);
+        std::string contents;
+        std::string_view text;
+        if (mapping.is_mapped()) {
+            text = std::string_view(mapping.data(), mapping.size());
+        } else {
+            contents = read_all(file);
+            text = contents;
+        }
+
+        if (thread_count == 0) thread_count = std::max(1u, std::thread::hardware_concurrency());
+        std::vector<std::string_view> chunks = split_at_lines(text, thread_count);
+        std::vector<ParsedChunk> results(chunks.size());
+
+        // A tiny thread pool: each worker grabs the next unparsed chunk
+        std::atomic<size_t> next_chunk{0};
+        auto worker = [&]() {
+            for (size_t c = next_chunk++; c < chunks.size(); c = next_chunk++) {
+                parse_chunk(chunks[c], results[c]);
+            }
+        };
+        size_t worker_count = std::min<size_t>(thread_count, chunks.size());
+        std::vector<std::thread> workers;
+        for (size_t w = 1; w < worker_count; ++w) workers.emplace_back(worker);
+        worker();  // This thread works too
+        for (auto& t : workers) t.join();
+
+        // Merge in the original order
+        size_t total = 0;
+        for (const auto& chunk : results) total += chunk.students.size();
+        std::vector<Student> students;
+        students.reserve(total);
+        size_t lines_before = 0;  // Chunks count their lines from 1
+        for (auto& chunk : results) {
+            for (LineDiagnostic& diagnostic : chunk.diagnostics) {
+                diagnostic.line_number += lines_before;
+                diagnostics.push_back(std::move(diagnostic));
             }
+            lines_before += chunk.line_count;
+            std::move(chunk.students.begin(), chunk.students.end(), std::back_inserter(students));
         }
 
-        // File automatically closed here when 'file' goes out of scope
+        // File (and mapping) automatically closed here
+        return students;
+    }
+
+    // Same, but prints a warning for every bad line
+    std::vector<Student> load_students(unsigned thread_count = 0) {
+        std::vector<LineDiagnostic> diagnostics;
+        std::vector<Student> students = load_students(diagnostics, thread_count);
+        for (const LineDiagnostic& diagnostic : diagnostics) {
+            print_warning(diagnostic);
+        }
         return students;
     }
+
+    // Streaming variant for files larger than memory: reads the file in
+    // blocks and calls on_student(const Student&) for each student, in file
+    // order. Only one block and ONE Student object are in memory at a time
+    // (the Student is reused, so copy it if you want to keep it).
+    // Returns the number of students passed to the callback.
+    // block_size is raised to at least 4 KB: a zero-byte read "succeeds"
+    // forever, and tiny blocks only add overhead.
+    template<typename Callback>
+    size_t for_each_student(Callback on_student, size_t block_size = size_t(1) << 20) {
+        std::ifstream file(filename, std::ios::binary);
+
+        if (!file.is_open()) {
+            throw std::runtime_error("Failed to open file for reading: " + filename);
+        }
+
+        std::vector<char> buffer(std::max(block_size, size_t(4096)));
+        std::string carry;  // Unfinished last line of the previous block
+        Student scratch(0, "");
+        size_t count = 0;
+        size_t line_number = 0;  // Lines before the current block
+
+        auto handle_line = [&](std::string_view line, size_t number) {
+            StudentParseError error = Student::try_parse_into(line, scratch);
+            if (!error.ok()) {
+                print_warning(make_diagnostic(number, error, line));
+                return;
+            }
+            on_student(static_cast<const Student&>(scratch));
+            ++count;
+        };
+
+        while (file.read(buffer.data(), static_cast<std::streamsize>(buffer.size())) || file.gcount() > 0) {
+            std::string_view block(buffer.data(), static_cast<size_t>(file.gcount()));
+            size_t last_newline = block.rfind('\n');
+            if (last_newline == std::string_view::npos) {  // No line ends in this block
+                carry.append(block.data(), block.size());
+                continue;
+            }
+            // The carried piece + the start of this block form one line
+            size_t first_newline = block.find('\n');
+            carry.append(block.data(), first_newline);
+            ++line_number;
+            if (!carry.empty() && carry[0] != '#') handle_line(carry, line_number);
+            carry.clear();
+
+            line_number += for_each_line(block.substr(first_newline + 1, last_newline - first_newline),
+                                         handle_line, line_number + 1);
+            carry.assign(block.data() + last_newline + 1, block.size() - last_newline - 1);
+        }
+        if (!carry.empty() && carry[0] != '#') handle_line(carry, line_number + 1);  // Last line without '\n'
+        return count;
+    }
+
+private:
+    struct ParsedChunk {
+        std::vector<Student> students;
+        std::vector<LineDiagnostic> diagnostics;  // Line numbers count from the chunk start
+        size_t line_count = 0;
+    };
+
+    // Calls handle_line(line, line_number) for every data line of 'text'
+    // (without '\n'); the first line has number 'first_line'.
+    // Empty lines and comment lines starting with '#' (like the "#seq N"
+    // header written by save_students) are skipped, but still counted.
+    // Returns the number of lines in 'text'.
+    template<typename LineHandler>
+    static size_t for_each_line(std::string_view text, LineHandler&& handle_line, size_t first_line = 1) {
+        size_t pos = 0;
+        size_t lines = 0;
+        while (pos < text.size()) {
+            size_t end = text.find('\n', pos);
+            if (end == std::string_view::npos) end = text.size();
+            if (end > pos && text[pos] != '#') handle_line(text.substr(pos, end - pos), first_line + lines);
+            ++lines;
+            pos = end + 1;
+        }
+        return lines;
+    }
+
+    // No exceptions here: a bad line costs about as much as a good one
+    static void parse_chunk(std::string_view text, ParsedChunk& out) {
+        out.line_count = for_each_line(text, [&out](std::string_view line, size_t number) {
+            out.students.emplace_back(0, "");
+            StudentParseError error = Student::try_parse_into(line, out.students.back());
+            if (!error.ok()) {
+                out.students.pop_back();
+                out.diagnostics.push_back(make_diagnostic(number, error, line));
+            }
+        });
+    }
+
+    static LineDiagnostic make_diagnostic(size_t line_number, const StudentParseError& error, std::string_view line) {
+        return LineDiagnostic{line_number, error, std::string(line.substr(0, 80))};
+    }
+
+    static void print_warning(const LineDiagnostic& diagnostic) {
+        std::cerr << "Warning: Skipping invalid line " << diagnostic.line_number << ": "
+                  << diagnostic.error.message() << " (column " << diagnostic.error.column + 1 << ")\n";
+    }
+
+    // Cuts 'text' into about 4 chunks per thread (so a fast thread can take
+    // more of them), each ending right after a '\n'. Small texts are not
+    // worth splitting.
+    static std::vector<std::string_view> split_at_lines(std::string_view text, unsigned thread_count) {
+        const size_t min_chunk = size_t(1) << 20;
+        size_t wanted = std::max<size_t>(1, std::min<size_t>(size_t(thread_count) * 4, text.size() / min_chunk));
+
+        std::vector<std::string_view> chunks;
+        size_t begin = 0;
+        for (size_t c = 1; c <= wanted && begin < text.size(); ++c) {
+            size_t end = c == wanted ? text.size() : std::max(begin, text.size() / wanted * c);
+            if (end < text.size()) {
+                size_t newline = text.find('\n', end);
+                end = newline == std::string_view::npos ? text.size() : newline + 1;
+            }
+            chunks.push_back(text.substr(begin, end - begin));
+            begin = end;
+        }
+        return chunks;
+    }
+
+    static std::string read_all(std::ifstream& file) {
+        file.seekg(0, std::ios::end);
+        std::streamoff size = file.tellg();
+        file.seekg(0, std::ios::beg);
+        if (size < 0) {  // Not seekable (e.g. a pipe): read it piece by piece
+            file.clear();
+            std::ostringstream all;
+            all << file.rdbuf();
+            return all.str();
+        }
+        std::string contents(static_cast<size_t>(size), '\0');
+        file.read(&contents[0], size);
+        contents.resize(static_cast<size_t>(file.gcount()));
+        return contents;
+    }
 };
 
 // -----------------------------------------------------------------------------
-// Student Management System
+// External Sort (files larger than memory)
 // -----------------------------------------------------------------------------
-
-class StudentManagementSystem {
+// Loading a whole roster and calling std::sort needs the whole file in
+// memory. An EXTERNAL sort needs only a fixed memory budget:
+//
+// 1. RUNS: read as many lines as fit into the budget, sort them, write
+//    them to a temporary "run" file. Repeat until the input is used up.
+// 2. MERGE: every run is sorted, so the smallest remaining line is always
+//    at the front of one of them. Read all runs at the same time and keep
+//    taking the smallest front line. With too many runs to open at once,
+//    merge groups of them first (several passes).
+//
+// Picking the smallest of k front lines uses a LOSER TREE: a tournament
+// where each inner node remembers the loser of its match. After taking the
+// winner, only the matches on ITS path to the root are replayed: log2(k)
+// comparisons per line instead of k.
+//
+// Reading and writing happen on helper threads (read-ahead and
+// write-behind): while the main thread sorts or merges, the next blocks
+// are already being read and the finished ones written.
+//
+// Lines are copied unchanged; lines load_students() would skip (bad data,
+// '#' comments such as "#seq N" or an index footer) are left out.
+
+// A bounded queue of data blocks between two threads
+class BlockQueue {
 private:
-    std::vector<Student> students;
-    StudentFileManager file_manager;
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::deque<std::string> blocks;
+    size_t capacity;
+    bool finished = false;   // The producer has no more blocks
+    bool cancelled = false;  // Stop now (error or early exit)
 
 public:
-    StudentManagementSystem(const std::string& data_file)
-        : file_manager(data_file) {
-        try {
-            students = file_manager.load_students();
-            std::cout << "Loaded " << students.size() << " students from file.\n";
-        } catch (const std::exception& e) {
-            std::cout << "Warning: Could not load existing data: "
-                      << e.what() << "\n";
-            std::cout << "Starting with empty student list.\n";
-        }
+    explicit BlockQueue(size_t max_blocks) : capacity(max_blocks) {}
+
+    // Waits while the queue is full; false if the queue was cancelled
+    bool push(std::string block) {
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait(lock, [this] { return blocks.size() < capacity || cancelled; });
+        if (cancelled) return false;
+        blocks.push_back(std::move(block));
+        changed.notify_all();
+        return true;
     }
 
-    ~StudentManagementSystem() {
-        try {
-            file_manager.save_students(students);
-            std::cout << "Saved " << students.size() << " students to file.\n";
-        } catch (const std::exception& e) {
-            std::cout << "Warning: Could not save data: "
-                      << e.what() << "\n";
+    // Waits for a block; false when there are no more
+    bool pop(std::string& block) {
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait(lock, [this] { return !blocks.empty() || finished || cancelled; });
+        if (cancelled || blocks.empty()) return false;
+        block = std::move(blocks.front());
+        blocks.pop_front();
+        changed.notify_all();
+        return true;
+    }
+
+    void finish() {
+        std::lock_guard<std::mutex> lock(mutex);
+        finished = true;
+        changed.notify_all();
+    }
+
+    void cancel() {
+        std::lock_guard<std::mutex> lock(mutex);
+        cancelled = true;
+        changed.notify_all();
+    }
+};
+
+// Reads a file block by block on its own thread, up to 'depth' blocks ahead
+class AsyncBlockReader {
+private:
+    std::ifstream file;
+    BlockQueue queue;
+    std::thread thread;
+
+public:
+    AsyncBlockReader(const std::string& path, size_t block_size, size_t depth = 2)
+        : file(path, std::ios::binary), queue(depth) {
+        if (!file.is_open()) {
+            throw std::runtime_error("Failed to open file for reading: " + path);
+        }
+        thread = std::thread([this, block_size]() {
+            while (true) {
+                std::string block(block_size, '\0');
+                file.read(&block[0], static_cast<std::streamsize>(block.size()));
+                block.resize(static_cast<size_t>(file.gcount()));
+                if (block.empty() || !queue.push(std::move(block))) break;
+            }
+            queue.finish();
+        });
+    }
+
+    ~AsyncBlockReader() {
+        queue.cancel();
+        thread.join();
+    }
+
+    AsyncBlockReader(const AsyncBlockReader&) = delete;
+    AsyncBlockReader& operator=(const AsyncBlockReader&) = delete;
+
+    bool next(std::string& block) { return queue.pop(block); }
+};
+
+// Writes blocks to a file on its own thread; close() reports errors
+class AsyncBlockWriter {
+private:
+    std::string path;
+    std::ofstream file;
+    BlockQueue queue;
+    std::thread thread;
+    bool failed = false;  // Set by the writer thread, read after join()
+
+public:
+    explicit AsyncBlockWriter(const std::string& file_path, size_t depth = 2)
+        : path(file_path), file(file_path, std::ios::binary), queue(depth) {
+        if (!file.is_open()) {
+            throw std::runtime_error("Failed to open file for writing: " + path);
+        }
+        thread = std::thread([this]() {
+            std::string block;
+            while (queue.pop(block)) {
+                if (!file.write(block.data(), static_cast<std::streamsize>(block.size()))) {
+                    failed = true;
+                    queue.cancel();
+                    break;
+                }
+            }
+        });
+    }
+
+    ~AsyncBlockWriter() {
+        if (thread.joinable()) {
+            queue.cancel();
+            thread.join();
+        }
+    }
+
+    AsyncBlockWriter(const AsyncBlockWriter&) = delete;
+    AsyncBlockWriter& operator=(const AsyncBlockWriter&) = delete;
+
+    void write(std::string block) {
+        if (!queue.push(std::move(block))) {
+            throw std::runtime_error("Failed to write file: " + path);
+        }
+    }
+
+    void close() {
+        queue.finish();
+        thread.join();
+        file.flush();
+        if (failed || !file) {
+            throw std::runtime_error("Failed to write file: " + path);
+        }
+        file.close();
+    }
+};
+
+enum class StudentSortKey { Gpa, Id, Name };
+
+struct SortProgress {
+    size_t pass;           // 0 = creating runs, 1, 2, ... = merge passes
+    uint64_t bytes_done;   // Bytes read (pass 0) or written (merge passes)
+    uint64_t bytes_total;
+    size_t runs;           // Runs created so far / runs left to merge
+};
+
+struct SortResult {
+    size_t students = 0;
+    size_t skipped_lines = 0;  // Bad lines and comments
+    size_t runs = 0;
+    size_t merge_passes = 0;
+};
+
+class ExternalStudentSorter {
+public:
+    // Order: GPA highest first, id ascending, or name ascending; ties by id
+    // (equal ids keep their input order)
+    ExternalStudentSorter(StudentSortKey sort_key, size_t memory_budget_bytes = size_t(64) << 20)
+        : key(sort_key), memory_budget(memory_budget_bytes) {}
+
+    // Called after every block; keep it cheap
+    void set_progress(std::function<void(const SortProgress&)> callback) {
+        progress = std::move(callback);
+    }
+
+    // Sorts 'input' into 'output' (written under a temporary name and then
+    // renamed, like save_students). Temporary run files are named
+    // output + ".runN" and removed afterwards.
+    SortResult sort(const std::string& input, const std::string& output) {
+        SortResult result;
+        std::vector<std::string> runs = create_runs(input, output, result);
+        result.runs = runs.size();
+
+        const std::string temp_name = output + ".tmp";
+        size_t next_run = runs.size();
+        try {
+            if (runs.empty()) {
+                std::ofstream(temp_name, std::ios::binary);  // Empty input: empty output
+            }
+            // Merge groups of up to fan_in() runs until one run is left
+            while (runs.size() > 1) {
+                ++result.merge_passes;
+                uint64_t pass_total = 0;
+                for (const std::string& run : runs) pass_total += file_size(run);
+                uint64_t pass_done = 0;
+
+                std::vector<std::string> merged;
+                for (size_t first = 0; first < runs.size(); first += fan_in()) {
+                    size_t last = std::min(runs.size(), first + fan_in());
+                    std::vector<std::string> group(runs.begin() + first, runs.begin() + last);
+                    bool final_merge = first == 0 && last == runs.size();
+                    std::string target = final_merge ? temp_name : run_name(output, next_run++);
+                    merge_runs(group, target, result.merge_passes, pass_done, pass_total, runs.size());
+                    for (const std::string& run : group) std::remove(run.c_str());
+                    merged.push_back(target);
+                }
+                runs = merged;
+            }
+            if (runs.size() == 1 && runs[0] != temp_name) {
+                std::remove(temp_name.c_str());
+                if (std::rename(runs[0].c_str(), temp_name.c_str()) != 0) {
+                    throw std::runtime_error("Failed to rename run file: " + runs[0]);
+                }
+            }
+        } catch (...) {
+            for (size_t number = 0; number < next_run; ++number) {
+                std::remove(run_name(output, number).c_str());
+            }
+            std::remove(temp_name.c_str());
+            throw;
+        }
+
+        if (std::rename(temp_name.c_str(), output.c_str()) != 0) {
+            std::remove(output.c_str());  // Some platforms refuse to replace a file
+            if (std::rename(temp_name.c_str(), output.c_str()) != 0) {
+                throw std::runtime_error("Failed to replace file: " + output);
+            }
+        }
+        return result;
+    }
+
+private:
+    static constexpr size_t block_size = size_t(256) << 10;
+
+    StudentSortKey key;
+    size_t memory_budget;
+    std::function<void(const SortProgress&)> progress;
+
+    // What lines are compared by
+    struct LineKey {
+        double gpa = 0.0;
+        int id = 0;
+        std::string_view name;
+    };
+
+    bool key_less(const LineKey& a, const LineKey& b) const {
+        switch (key) {
+            case StudentSortKey::Gpa:
+                return a.gpa > b.gpa || (a.gpa == b.gpa && a.id < b.id);
+            case StudentSortKey::Id:
+                return a.id < b.id;
+            case StudentSortKey::Name:
+                return a.name < b.name || (a.name == b.name && a.id < b.id);
+        }
+        return false;
+    }
+
+    // Fills 'out' from a data line. Only the GPA needs the whole line
+    // parsed; scratch is reused to avoid allocations.
+    static bool extract_key(std::string_view line, LineKey& out, Student& scratch) {
+        if (!Student::try_parse_into(line, scratch).ok()) return false;
+        out.gpa = scratch.calculate_gpa();
+        out.id = scratch.get_id();
+        size_t name_start = line.find(',');
+        if (name_start == std::string_view::npos) {
+            out.name = line.substr(line.size());  // "5" (id only): empty name, still inside the line
+        } else {
+            size_t name_end = line.find(',', name_start + 1);
+            out.name = line.substr(name_start + 1, name_end == std::string_view::npos
+                                                       ? std::string_view::npos
+                                                       : name_end - name_start - 1);
+        }
+        return true;
+    }
+
+    // Runs that can be merged at once: each needs about three blocks
+    // (two read ahead, one being merged)
+    size_t fan_in() const {
+        return std::max<size_t>(2, std::min<size_t>(64, memory_budget / (3 * block_size)));
+    }
+
+    static std::string run_name(const std::string& output, size_t number) {
+        return output + ".run" + std::to_string(number);
+    }
+
+    static uint64_t file_size(const std::string& path) {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        return file.is_open() ? static_cast<uint64_t>(file.tellg()) : 0;
+    }
+
+    void report(size_t pass, uint64_t done, uint64_t total, size_t runs) const {
+        if (progress) progress(SortProgress{pass, done, total, runs});
+    }
+
+    // Calls handle_line for every complete line in a stream of blocks;
+    // a line split between two blocks is put together in 'carry'
+    class LineSplitter {
+    private:
+        std::string carry;
+
+    public:
+        template<typename Handler>
+        void feed(std::string_view block, Handler&& handle_line) {
+            size_t pos = 0;
+            while (pos < block.size()) {
+                size_t end = block.find('\n', pos);
+                if (end == std::string_view::npos) {
+                    carry.append(block.data() + pos, block.size() - pos);
+                    return;
+                }
+                if (carry.empty()) {
+                    handle_line(block.substr(pos, end - pos));
+                } else {
+                    carry.append(block.data() + pos, end - pos);
+                    handle_line(std::string_view(carry));
+                    carry.clear();
+                }
+                pos = end + 1;
+            }
+        }
+
+        template<typename Handler>
+        void finish(Handler&& handle_line) {
+            if (!carry.empty()) handle_line(std::string_view(carry));
+            carry.clear();
+        }
+    };
+
+    // Pass 0: cut the input into sorted runs that fit the memory budget
+    std::vector<std::string> create_runs(const std::string& input, const std::string& output,
+                                         SortResult& result) {
+        struct Record {
+            double gpa;
+            int id;
+            size_t offset;       // Line position in 'arena'
+            size_t length;
+            size_t name_offset;  // Name position in 'arena'
+            size_t name_length;
+        };
+        std::string arena;       // The lines of the current run, back to back
+        std::vector<Record> records;
+        std::vector<std::string> runs;
+        Student scratch(0, "");
+
+        // Budget minus the blocks of the reader and writer threads
+        size_t budget = memory_budget > 8 * block_size ? memory_budget - 6 * block_size : 2 * block_size;
+
+        auto write_run = [&]() {
+            if (records.empty()) return;
+            auto key_of = [&arena](const Record& record) {
+                return LineKey{record.gpa, record.id,
+                               std::string_view(arena).substr(record.name_offset, record.name_length)};
+            };
+            std::sort(records.begin(), records.end(), [this, &key_of](const Record& a, const Record& b) {
+                LineKey key_a = key_of(a), key_b = key_of(b);
+                if (key_less(key_a, key_b)) return true;
+                if (key_less(key_b, key_a)) return false;
+                return a.offset < b.offset;  // Keep input order for ties
+            });
+
+            runs.push_back(run_name(output, runs.size()));
+            AsyncBlockWriter writer(runs.back());
+            std::string buffer;
+            buffer.reserve(block_size + 4096);
+            for (const Record& record : records) {
+                buffer.append(arena, record.offset, record.length);
+                buffer += '\n';
+                if (buffer.size() >= block_size) {
+                    writer.write(std::move(buffer));
+                    buffer = std::string();
+                    buffer.reserve(block_size + 4096);
+                }
+            }
+            writer.write(std::move(buffer));
+            writer.close();
+
+            records.clear();
+            arena.clear();
+        };
+
+        try {
+            uint64_t total = file_size(input);
+            uint64_t done = 0;
+            AsyncBlockReader reader(input, block_size);
+            LineSplitter splitter;
+            LineKey line_key;
+
+            auto handle_line = [&](std::string_view line) {
+                if (line.empty()) return;
+                if (line[0] == '#' || !extract_key(line, line_key, scratch)) {
+                    ++result.skipped_lines;
+                    return;
+                }
+                if (!records.empty() &&
+                    arena.size() + line.size() + (records.size() + 1) * sizeof(Record) > budget) {
+                    write_run();
+                    report(0, done, total, runs.size());
+                }
+                size_t name_offset = static_cast<size_t>(line_key.name.data() - line.data());
+                records.push_back(Record{line_key.gpa, line_key.id, arena.size(), line.size(),
+                                         arena.size() + name_offset, line_key.name.size()});
+                arena.append(line.data(), line.size());
+                ++result.students;
+            };
+
+            std::string block;
+            while (reader.next(block)) {
+                splitter.feed(block, handle_line);
+                done += block.size();
+                report(0, done, total, runs.size());
+            }
+            splitter.finish(handle_line);
+            write_run();
+            report(0, done, total, runs.size());
+        } catch (...) {
+            for (const std::string& run : runs) std::remove(run.c_str());
+            throw;
+        }
+        return runs;
+    }
+
+    // One sorted input of a merge
+    class RunCursor {
+    private:
+        AsyncBlockReader reader;
+        std::string block;
+        std::string_view rest;   // Unread part of 'block'
+        std::string carry;       // A line split between two blocks
+        Student scratch{0, ""};
+
+    public:
+        std::string_view line;   // The current line (valid until advance())
+        LineKey key;
+        bool done = false;
+
+        explicit RunCursor(const std::string& path) : reader(path, block_size) {}
+
+        // Moves to the next line; the previous one is no longer needed
+        void advance() {
+            if (!carry.empty() && line.data() == carry.data()) carry.clear();
+            while (true) {
+                size_t end = rest.find('\n');
+                if (end != std::string_view::npos) {
+                    if (carry.empty()) {
+                        line = rest.substr(0, end);
+                    } else {
+                        carry.append(rest.data(), end);
+                        line = carry;
+                    }
+                    rest.remove_prefix(end + 1);
+                    break;
+                }
+                carry.append(rest.data(), rest.size());
+                if (!reader.next(block)) {
+                    if (carry.empty()) {
+                        done = true;
+                        return;
+                    }
+                    line = carry;  // Last line without '\n'
+                    rest = std::string_view();
+                    break;
+                }
+                rest = block;
+            }
+            extract_key(line, key, scratch);  // Runs contain only valid lines
+        }
+    };
+
+    // The loser tree over k cursors. Node 0 holds the overall winner,
+    // nodes 1..k-1 the losers of their matches; cursor i is leaf k+i.
+    class LoserTree {
+    private:
+        const ExternalStudentSorter& sorter;
+        std::vector<std::unique_ptr<RunCursor>>& cursors;
+        std::vector<size_t> tree;
+
+        // Does cursor a come before cursor b? Finished cursors lose every
+        // match; for equal keys the earlier run wins (stable)
+        bool beats(size_t a, size_t b) const {
+            if (cursors[a]->done) return false;
+            if (cursors[b]->done) return true;
+            if (sorter.key_less(cursors[a]->key, cursors[b]->key)) return true;
+            if (sorter.key_less(cursors[b]->key, cursors[a]->key)) return false;
+            return a < b;
+        }
+
+    public:
+        LoserTree(const ExternalStudentSorter& owner, std::vector<std::unique_ptr<RunCursor>>& inputs)
+            : sorter(owner), cursors(inputs), tree(inputs.size()) {
+            size_t k = cursors.size();
+            std::vector<size_t> winner(2 * k);
+            for (size_t i = 0; i < k; ++i) winner[k + i] = i;
+            for (size_t node = k - 1; node >= 1; --node) {  // Play all first-round matches
+                size_t a = winner[2 * node], b = winner[2 * node + 1];
+                bool a_wins = beats(a, b);
+                winner[node] = a_wins ? a : b;
+                tree[node] = a_wins ? b : a;
+            }
+            tree[0] = k == 1 ? 0 : winner[1];
+        }
+
+        size_t winner() const { return tree[0]; }
+        bool empty() const { return cursors[tree[0]]->done; }
+
+        // The winner has moved to its next line: replay its path to the root
+        void replay() {
+            size_t k = cursors.size();
+            size_t current = tree[0];
+            for (size_t node = (current + k) / 2; node >= 1; node /= 2) {
+                if (beats(tree[node], current)) std::swap(tree[node], current);
+            }
+            tree[0] = current;
+        }
+    };
+
+    void merge_runs(const std::vector<std::string>& group, const std::string& target, size_t pass,
+                    uint64_t& done, uint64_t total, size_t runs_left) {
+        std::vector<std::unique_ptr<RunCursor>> cursors;
+        for (const std::string& run : group) {
+            cursors.push_back(std::make_unique<RunCursor>(run));
+            cursors.back()->advance();
+        }
+        LoserTree tree(*this, cursors);
+
+        AsyncBlockWriter writer(target);
+        std::string buffer;
+        buffer.reserve(block_size + 4096);
+        while (!tree.empty()) {
+            RunCursor& cursor = *cursors[tree.winner()];
+            buffer.append(cursor.line.data(), cursor.line.size());
+            buffer += '\n';
+            cursor.advance();
+            tree.replay();
+
+            if (buffer.size() >= block_size) {
+                done += buffer.size();
+                writer.write(std::move(buffer));
+                buffer = std::string();
+                buffer.reserve(block_size + 4096);
+                report(pass, done, total, runs_left);
+            }
+        }
+        done += buffer.size();
+        writer.write(std::move(buffer));
+        writer.close();
+        report(pass, done, total, runs_left);
+    }
+};
+
+// -----------------------------------------------------------------------------
+// Indexed Student Roster
+// -----------------------------------------------------------------------------
+// A plain std::vector<Student> makes every operation a linear scan: finding
+// a student by id, checking for duplicates, and erase() (which also shifts
+// every student after the removed one). With a big roster every menu
+// choice becomes slow.
+//
+// StudentRoster keeps three structures in sync:
+//   - slots:        the students themselves. A removed student's slot is
+//                   marked free and reused later, so nothing ever moves
+//   - slot_by_id:   hash map id -> slot, for O(1) lookup
+//   - gpa_index:    students sorted by GPA (a balanced tree, see below),
+//                   for rank, percentile and top-N queries in O(log n)
+//
+// In LAZY mode (attach) a slot may hold only the id and GPA from the file's
+// index; the record is read on first access. Unchanged records that were
+// read form a cache with a size limit: when it is full, the least recently
+// used record is dropped (LRU) - it can always be read again.
+
+// GpaRankIndex - an "order-statistic tree": a balanced binary search tree
+// where every node also stores the size of its subtree. With those sizes
+// you can count how many keys are smaller than any value in O(log n),
+// without visiting them.
+//
+// The tree is a TREAP: each node gets a random priority, and the tree is
+// kept a heap on the priorities. Random priorities keep it balanced on
+// average, and all operations reduce to split() and merge().
+// Nodes live in a vector and refer to each other by index instead of by
+// pointer: fewer allocations, and freed nodes are reused.
+class GpaRankIndex {
+public:
+    // Ordered by GPA, ties by DESCENDING id - so walking from the highest
+    // key lists the best GPA first, and equal GPAs by ascending id
+    struct Key {
+        double gpa;
+        int id;
+    };
+
+private:
+    struct Node {
+        Key key;
+        uint32_t priority;
+        int left;
+        int right;
+        size_t size;  // Number of nodes in this subtree
+    };
+
+    std::vector<Node> nodes;
+    std::vector<int> free_nodes;
+    int root = -1;
+    uint32_t random_state = 2463534242u;
+
+    static bool less(const Key& a, const Key& b) {
+        return a.gpa < b.gpa || (a.gpa == b.gpa && a.id > b.id);
+    }
+
+    size_t size_of(int node) const { return node < 0 ? 0 : nodes[node].size; }
+
+    void update_size(int node) {
+        nodes[node].size = 1 + size_of(nodes[node].left) + size_of(nodes[node].right);
+    }
+
+    // xorshift32: fast pseudo-random priorities
+    uint32_t next_priority() {
+        random_state ^= random_state << 13;
+        random_state ^= random_state >> 17;
+        random_state ^= random_state << 5;
+        return random_state;
+    }
+
+    // Splits the tree at 'node' into keys < key (lower) and keys >= key (upper)
+    void split(int node, const Key& key, int& lower, int& upper) {
+        if (node < 0) {
+            lower = upper = -1;
+            return;
+        }
+        if (less(nodes[node].key, key)) {
+            split(nodes[node].right, key, nodes[node].right, upper);
+            lower = node;
+        } else {
+            split(nodes[node].left, key, lower, nodes[node].left);
+            upper = node;
+        }
+        update_size(node);
+    }
+
+    // Joins two trees where every key in 'lower' is < every key in 'upper'
+    int merge(int lower, int upper) {
+        if (lower < 0) return upper;
+        if (upper < 0) return lower;
+        if (nodes[lower].priority > nodes[upper].priority) {
+            nodes[lower].right = merge(nodes[lower].right, upper);
+            update_size(lower);
+            return lower;
+        }
+        nodes[upper].left = merge(lower, nodes[upper].left);
+        update_size(upper);
+        return upper;
+    }
+
+    size_t compute_sizes(int node) {
+        if (node < 0) return 0;
+        nodes[node].size = 1 + compute_sizes(nodes[node].left) + compute_sizes(nodes[node].right);
+        return nodes[node].size;
+    }
+
+    int erase_from(int node, const Key& key) {
+        if (node < 0) return -1;
+        if (less(key, nodes[node].key)) {
+            nodes[node].left = erase_from(nodes[node].left, key);
+        } else if (less(nodes[node].key, key)) {
+            nodes[node].right = erase_from(nodes[node].right, key);
+        } else {
+            int joined = merge(nodes[node].left, nodes[node].right);
+            free_nodes.push_back(node);
+            return joined;
+        }
+        update_size(node);
+        return node;
+    }
+
+public:
+    size_t size() const { return size_of(root); }
+
+    void insert(const Key& key) {
+        int node;
+        if (free_nodes.empty()) {
+            node = static_cast<int>(nodes.size());
+            nodes.push_back(Node{});
+        } else {
+            node = free_nodes.back();
+            free_nodes.pop_back();
+        }
+        nodes[node] = Node{key, next_priority(), -1, -1, 1};
+
+        int lower, upper;
+        split(root, key, lower, upper);
+        root = merge(merge(lower, node), upper);
+    }
+
+    void erase(const Key& key) {
+        root = erase_from(root, key);
+    }
+
+    // Replaces the contents with 'keys' in O(n log n) for the sort plus
+    // O(n) to link the nodes - much faster than n separate inserts, which
+    // jump around in memory. With the keys sorted, each new node is the
+    // right-most so far: a stack of the tree's right edge is enough to find
+    // where it goes (a "Cartesian tree" build).
+    void build(std::vector<Key> keys) {
+        std::sort(keys.begin(), keys.end(), [](const Key& a, const Key& b) { return less(a, b); });
+        nodes.clear();
+        free_nodes.clear();
+        nodes.reserve(keys.size());
+
+        std::vector<int> right_edge;
+        for (const Key& key : keys) {
+            int node = static_cast<int>(nodes.size());
+            nodes.push_back(Node{key, next_priority(), -1, -1, 1});
+            int last_popped = -1;
+            while (!right_edge.empty() && nodes[right_edge.back()].priority < nodes[node].priority) {
+                last_popped = right_edge.back();
+                right_edge.pop_back();
+            }
+            nodes[node].left = last_popped;
+            if (!right_edge.empty()) nodes[right_edge.back()].right = node;
+            right_edge.push_back(node);
+        }
+        root = right_edge.empty() ? -1 : right_edge.front();
+        if (root >= 0) compute_sizes(root);
+    }
+
+    // Number of keys with gpa < value (or <= value if 'inclusive')
+    size_t count_below(double value, bool inclusive) const {
+        size_t count = 0;
+        int node = root;
+        while (node >= 0) {
+            double gpa = nodes[node].key.gpa;
+            if (gpa < value || (inclusive && gpa == value)) {
+                count += size_of(nodes[node].left) + 1;
+                node = nodes[node].right;
+            } else {
+                node = nodes[node].left;
+            }
+        }
+        return count;
+    }
+
+    // Calls visit(key) for the 'limit' largest keys, largest first
+    template<typename Visit>
+    void for_each_descending(size_t limit, Visit visit) const {
+        std::vector<int> path;  // Explicit stack for a reverse in-order walk
+        int node = root;
+        while (limit > 0 && (node >= 0 || !path.empty())) {
+            while (node >= 0) {
+                path.push_back(node);
+                node = nodes[node].right;
+            }
+            node = path.back();
+            path.pop_back();
+            visit(nodes[node].key);
+            --limit;
+            node = nodes[node].left;
+        }
+    }
+};
+
+class StudentRoster {
+private:
+    static constexpr size_t no_record = static_cast<size_t>(-1);
+
+    struct Slot {
+        Student student;
+        double gpa;      // GPA stored in gpa_index (needed to find the key again)
+        bool used;
+        bool loaded;     // false: the record is still only in the file
+        bool pinned;     // New or changed: the only copy is in memory, never evicted
+        size_t record;   // Record number in 'source', or no_record
+        std::list<size_t>::iterator cache_position;  // Valid if loaded && !pinned
+        size_t last_command;  // Last command that read it (see begin_command)
+    };
+
+    // Reading a record on first access does not change what the roster
+    // contains, so lookups stay const - the cache members are 'mutable'
+    mutable std::vector<Slot> slots;
+    mutable std::list<size_t> cache_order;  // Cached slots, most recently used first
+    std::vector<size_t> free_slots;
+    std::unordered_map<int, size_t> slot_by_id;
+    GpaRankIndex gpa_index;
+    std::unique_ptr<IndexedStudentFile> source;  // Lazy mode only
+    size_t cache_capacity = 0;
+    mutable size_t command = 0;  // Counts begin_command() calls
+
+    // Makes sure the slot's student is in memory and marks it as recently
+    // used, then drops older records until the cache fits its capacity
+    Slot& load(size_t index) const {
+        Slot& slot = slots[index];
+        if (!slot.loaded) {
+            source->read(slot.record, slot.student);
+            slot.loaded = true;
+            cache_order.push_front(index);
+            slot.cache_position = cache_order.begin();
+        } else if (!slot.pinned) {
+            cache_order.splice(cache_order.begin(), cache_order, slot.cache_position);
+        }
+        slot.last_command = command;
+        evict_down_to(cache_capacity);
+        return slot;
+    }
+
+    // Records read by the current command are the most recently used, so
+    // the loop stops at the first one: their pointers must stay valid
+    void evict_down_to(size_t capacity) const {
+        while (cache_order.size() > capacity && slots[cache_order.back()].last_command != command) {
+            Slot& slot = slots[cache_order.back()];
+            cache_order.pop_back();
+            slot.student = Student(slot.student.get_id(), "");  // Release the name and grades
+            slot.loaded = false;
+        }
+    }
+
+    // Bulk-builds the GPA index if it is empty, else inserts one by one
+    void add_to_gpa_index(std::vector<GpaRankIndex::Key> keys) {
+        if (gpa_index.size() == 0) {
+            gpa_index.build(std::move(keys));
+        } else {
+            for (const GpaRankIndex::Key& key : keys) gpa_index.insert(key);
+        }
+    }
+
+    void pin(Slot& slot) {
+        if (!slot.pinned) {
+            cache_order.erase(slot.cache_position);
+            slot.pinned = true;
+        }
+    }
+
+public:
+    size_t size() const { return slot_by_id.size(); }
+    bool empty() const { return slot_by_id.empty(); }
+    bool contains(int id) const { return slot_by_id.count(id) != 0; }
+
+    // Lazy mode: takes every student from the file's index WITHOUT reading
+    // the records. At most 'capacity' (at least 1) unchanged records are
+    // kept in memory (see begin_command). Returns the number of duplicate
+    // IDs skipped.
+    size_t attach(std::unique_ptr<IndexedStudentFile> file, size_t capacity) {
+        source = std::move(file);
+        cache_capacity = std::max(capacity, size_t(1));
+        size_t duplicates = 0;
+        std::vector<GpaRankIndex::Key> keys;
+        keys.reserve(source->size());
+        slots.reserve(slots.size() + source->size());
+        slot_by_id.reserve(slot_by_id.size() + source->size());
+        for (size_t record = 0; record < source->size(); ++record) {
+            const StudentIndexEntry& entry = source->entry(record);
+            if (!slot_by_id.emplace(entry.id, slots.size()).second) {
+                ++duplicates;
+                continue;
+            }
+            slots.push_back(Slot{Student(entry.id, ""), entry.gpa, true, false, false, record, {}, 0});
+            keys.push_back({entry.gpa, entry.id});
+        }
+        add_to_gpa_index(std::move(keys));
+        return duplicates;
+    }
+
+    // Adds many students at once (e.g. a whole file). Returns the number
+    // of duplicate IDs skipped.
+    size_t insert_all(std::vector<Student> students) {
+        size_t duplicates = 0;
+        std::vector<GpaRankIndex::Key> keys;
+        keys.reserve(students.size());
+        slots.reserve(slots.size() + students.size());
+        slot_by_id.reserve(slot_by_id.size() + students.size());
+        for (Student& student : students) {
+            int id = student.get_id();
+            if (!slot_by_id.emplace(id, slots.size()).second) {
+                ++duplicates;
+                continue;
+            }
+            double gpa = student.calculate_gpa();
+            slots.push_back(Slot{std::move(student), gpa, true, true, true, no_record, {}, 0});
+            keys.push_back({gpa, id});
+        }
+        add_to_gpa_index(std::move(keys));
+        return duplicates;
+    }
+
+    // Call before each command (menu choice, batch line). Reading a record
+    // drops the least recently used ones so that at most 'capacity' are in
+    // memory, but never one the current command has read: a pointer from
+    // find() stays valid until the next begin_command().
+    void begin_command() {
+        ++command;
+        evict_down_to(cache_capacity);
+    }
+
+    size_t cached_records() const { return cache_order.size(); }
+
+    // Returns false (and changes nothing) if the id is already taken
+    bool insert(Student student) {
+        int id = student.get_id();
+        if (slot_by_id.count(id)) return false;
+
+        double gpa = student.calculate_gpa();
+        Slot slot{std::move(student), gpa, true, true, true, no_record, {}, 0};
+        size_t index;
+        if (free_slots.empty()) {
+            index = slots.size();
+            slots.push_back(std::move(slot));
+        } else {
+            index = free_slots.back();
+            free_slots.pop_back();
+            slots[index] = std::move(slot);
+        }
+        slot_by_id.emplace(id, index);
+        gpa_index.insert({gpa, id});
+        return true;
+    }
+
+    // Returns false if there is no such student
+    bool erase(int id) {
+        auto found = slot_by_id.find(id);
+        if (found == slot_by_id.end()) return false;
+
+        Slot& slot = slots[found->second];
+        gpa_index.erase({slot.gpa, id});
+        if (slot.loaded && !slot.pinned) cache_order.erase(slot.cache_position);
+        slot.student = Student(0, "");  // Release the name and grades
+        slot.used = false;
+        free_slots.push_back(found->second);
+        slot_by_id.erase(found);
+        return true;
+    }
+
+    // In lazy mode this may read the record from the file
+    const Student* find(int id) const {
+        auto found = slot_by_id.find(id);
+        return found == slot_by_id.end() ? nullptr : &load(found->second).student;
+    }
+
+    // Students are only changed through the roster, so the GPA index
+    // stays correct. Returns false if there is no such student.
+    bool add_grade(int id, double grade) {
+        return add_grades(id, &grade, 1);
+    }
+
+    // Bulk import: the GPA index is updated once, not once per grade
+    bool add_grades(int id, const double* grades, size_t count) {
+        auto found = slot_by_id.find(id);
+        if (found == slot_by_id.end()) return false;
+
+        Slot& slot = load(found->second);
+        slot.student.add_grades(grades, count);  // May throw InvalidGradeException
+        pin(slot);  // The file has the old grades now
+        gpa_index.erase({slot.gpa, id});
+        slot.gpa = slot.student.calculate_gpa();
+        gpa_index.insert({slot.gpa, id});
+        return true;
+    }
+
+    // 1 = highest GPA; students with the same GPA share a rank
+    size_t rank(int id) const {
+        auto found = slot_by_id.find(id);
+        if (found == slot_by_id.end()) return 0;
+        return size() - gpa_index.count_below(slots[found->second].gpa, true) + 1;
+    }
+
+    // Percentage of students with a LOWER GPA than this one
+    double percentile(int id) const {
+        auto found = slot_by_id.find(id);
+        if (found == slot_by_id.end()) return 0.0;
+        return 100.0 * static_cast<double>(gpa_index.count_below(slots[found->second].gpa, false))
+             / static_cast<double>(size());
+    }
+
+    // Calls callback(const Student&) for the n students with the highest
+    // GPA, best first. Like for_each, records that are not in memory are
+    // read into a temporary Student, so a large n does not fill the cache.
+    template<typename Callback>
+    void for_each_top(size_t n, Callback callback) const {
+        Student scratch(0, "");
+        gpa_index.for_each_descending(n, [&](const GpaRankIndex::Key& key) {
+            const Slot& slot = slots[slot_by_id.find(key.id)->second];
+            if (slot.loaded) {
+                callback(static_cast<const Student&>(slot.student));
+            } else {
+                source->read(slot.record, scratch);
+                callback(static_cast<const Student&>(scratch));
+            }
+        });
+    }
+
+    // The n students with the highest GPA, best first (copies)
+    std::vector<Student> top(size_t n) const {
+        std::vector<Student> result;
+        result.reserve(std::min(n, size()));
+        for_each_top(n, [&result](const Student& student) { result.push_back(student); });
+        return result;
+    }
+
+    // Visits the students in slot order (removed students' slots are
+    // reused, so this is NOT necessarily the order they were added).
+    // Records that are not in memory are read into a temporary Student
+    // and not cached, so visiting everyone does not fill the cache.
+    template<typename Callback>
+    void for_each(Callback callback) const {
+        Student scratch(0, "");
+        for (const Slot& slot : slots) {
+            if (!slot.used) continue;
+            if (slot.loaded) {
+                callback(static_cast<const Student&>(slot.student));
+            } else {
+                source->read(slot.record, scratch);
+                callback(static_cast<const Student&>(scratch));
+            }
+        }
+    }
+
+    std::vector<Student> to_vector() const {
+        std::vector<Student> result;
+        result.reserve(size());
+        for_each([&result](const Student& student) { result.push_back(student); });
+        return result;
+    }
+};
+
+// -----------------------------------------------------------------------------
+// Append-Only Journal
+// -----------------------------------------------------------------------------
+// Saving the whole roster only in the destructor has two problems: a crash
+// loses every change since startup, and a big roster means a slow exit.
+//
+// Instead, every change is appended to a JOURNAL file the moment it happens:
+//
+//     <seq> <op> <data>        ops: A = add student ("id,name")
+//     1 A 1001,Alice                R = remove student ("id")
+//     2 G 1001,95.5                 G = add grade ("id,grade")
+//
+// Appending one short line is cheap no matter how big the roster is.
+// Every record has a sequence number (seq). Now and then the journal is
+// COMPACTED: the current roster is written as a new base file that starts
+// with "#seq N" (= contains records 1..N), and the old journal is deleted.
+// At startup: load the base file, then replay journal records with seq > N.
+
+bool file_exists(const std::string& path) {
+    return std::ifstream(path).is_open();
+}
+
+class StudentJournal {
+private:
+    std::string path;
+    std::ofstream out;
+
+public:
+    explicit StudentJournal(const std::string& journal_path) : path(journal_path) {
+        cut_incomplete_record(path);
+        out.open(path, std::ios::app);
+        if (!out.is_open()) {
+            throw std::runtime_error("Failed to open journal: " + path);
+        }
+    }
+
+    // flush() hands the line to the operating system, so it survives a
+    // crash of this program. (Surviving a power cut would also need fsync.)
+    void append(long long seq, char op, std::string_view data) {
+        char prefix[24];
+        char* end = std::to_chars(prefix, prefix + sizeof(prefix), seq).ptr;
+        *end++ = ' ';
+        *end++ = op;
+        *end++ = ' ';
+        out.write(prefix, end - prefix);
+        out.write(data.data(), static_cast<std::streamsize>(data.size()));
+        out.put('\n');
+        out.flush();
+        if (!out) {
+            throw std::runtime_error("Failed to write journal: " + path);
+        }
+    }
+
+    // A crash in the middle of append() leaves a last line without '\n'.
+    // replay() ignores it, but the next append would be glued to it
+    // ("3 A 5,Al" + "4 R 7" = "3 A 5,Al4 R 7", a valid-looking record).
+    // So the file is cut back to its last '\n' before anything is appended.
+    static void cut_incomplete_record(const std::string& journal_path) {
+        std::ifstream in(journal_path, std::ios::binary | std::ios::ate);
+        if (!in.is_open()) return;
+        std::streamoff size = in.tellg();
+
+        // Search backwards for the last '\n', one block at a time
+        std::streamoff keep = 0;
+        char block[4096];
+        for (std::streamoff end = size; end > 0 && keep == 0;) {
+            std::streamoff begin = std::max<std::streamoff>(0, end - static_cast<std::streamoff>(sizeof(block)));
+            in.seekg(begin);
+            in.read(block, end - begin);
+            for (std::streamoff i = end - begin; i > 0; --i) {
+                if (block[i - 1] == '\n') {
+                    keep = begin + i;
+                    break;
+                }
+            }
+            end = begin;
+        }
+        in.close();
+        if (keep == size) return;
+
+        std::error_code error;
+        std::filesystem::resize_file(journal_path, static_cast<std::uintmax_t>(keep), error);
+        if (error) {
+            throw std::runtime_error("Failed to repair journal: " + journal_path);
+        }
+        std::cerr << "Warning: Removed an incomplete record at the end of " << journal_path << "\n";
+    }
+
+    // Moves the current journal to 'rotated_path' and starts an empty one
+    void rotate(const std::string& rotated_path) {
+        out.close();
+        bool moved = std::rename(path.c_str(), rotated_path.c_str()) == 0;
+        out.open(path, std::ios::app);
+        if (!moved || !out.is_open()) {
+            throw std::runtime_error("Failed to rotate journal: " + path);
+        }
+    }
+
+    // Empties the journal (everything in it is in the base file now)
+    void clear() {
+        out.close();
+        out.open(path, std::ios::trunc);
+    }
+
+    // Calls apply(op, data) for every complete record in 'journal_path'
+    // with seq > after_seq, in order. A last line without '\n' was cut off
+    // by a crash in the middle of a write and is ignored.
+    // Returns the highest seq seen (or after_seq if there were none).
+    template<typename Apply>
+    static long long replay(const std::string& journal_path, long long after_seq, Apply apply) {
+        std::ifstream in(journal_path);
+        long long last_seq = after_seq;
+        std::string line;
+        while (std::getline(in, line)) {
+            if (in.eof()) break;  // No '\n' after this line: incomplete record
+
+            long long seq = 0;
+            std::from_chars_result result = std::from_chars(line.data(), line.data() + line.size(), seq);
+            if (result.ec != std::errc() || line.size() < static_cast<size_t>(result.ptr - line.data()) + 3) {
+                std::cerr << "Warning: Skipping corrupt journal record: " << line << "\n";
+                continue;
+            }
+            if (seq <= after_seq) continue;  // Already part of the base file
+
+            size_t op_pos = static_cast<size_t>(result.ptr - line.data()) + 1;
+            apply(line[op_pos], std::string_view(line).substr(op_pos + 2));
+            last_seq = std::max(last_seq, seq);
+        }
+        return last_seq;
+    }
+};
+
+// -----------------------------------------------------------------------------
+// Batch Command Report
+// -----------------------------------------------------------------------------
+// Timing statistics for StudentManagementSystem::run_batch(): how many
+// commands ran per second, and how long each kind of command took.
+// Single slow commands disappear in an average, so the report also shows
+// the median (p50), the 99th percentile (p99) and the maximum.
+
+struct CommandStats {
+    std::string name;
+    size_t failed = 0;
+    std::vector<long long> latencies_ns;  // One entry per executed command
+};
+
+struct BatchReport {
+    std::vector<CommandStats> commands;    // One entry per command type
+    size_t total = 0;
+    size_t failed = 0;
+    double seconds = 0.0;
+    std::vector<std::string> first_errors;  // "line N: message", at most 10
+
+    void print(std::ostream& out) const {
+        out << total << " commands in " << seconds * 1000.0 << " ms ("
+            << (seconds > 0.0 ? static_cast<double>(total) / seconds : 0.0)
+            << " commands/s), " << failed << " failed\n";
+        out << std::left << std::setw(10) << "command" << std::right
+            << std::setw(10) << "count" << std::setw(8) << "failed"
+            << std::setw(12) << "mean us" << std::setw(12) << "p50 us"
+            << std::setw(12) << "p99 us" << std::setw(12) << "max us" << "\n";
+
+        for (const CommandStats& stats : commands) {
+            if (stats.latencies_ns.empty()) continue;
+
+            std::vector<long long> sorted = stats.latencies_ns;
+            std::sort(sorted.begin(), sorted.end());
+            long long sum = 0;
+            for (long long ns : sorted) sum += ns;
+            auto at = [&sorted](double fraction) {
+                return static_cast<double>(sorted[static_cast<size_t>(fraction * (sorted.size() - 1))]) / 1000.0;
+            };
+
+            out << std::left << std::setw(10) << stats.name << std::right
+                << std::setw(10) << sorted.size() << std::setw(8) << stats.failed
+                << std::setw(12) << static_cast<double>(sum) / sorted.size() / 1000.0
+                << std::setw(12) << at(0.5) << std::setw(12) << at(0.99)
+                << std::setw(12) << static_cast<double>(sorted.back()) / 1000.0 << "\n";
+        }
+        for (const std::string& error : first_errors) {
+            out << "  " << error << "\n";
+        }
+    }
+};
+
+// -----------------------------------------------------------------------------
+// Student Management System
+// -----------------------------------------------------------------------------
+
+class StudentManagementSystem {
+private:
+    StudentRoster students;
+    StudentFileManager file_manager;
+    std::string journal_path;
+    std::string rotated_journal_path;  // Journal being compacted
+    StudentJournal journal;
+
+    long long last_seq = 0;       // seq of the newest change
+    size_t journal_records = 0;   // Records in the active journal
+    size_t compact_after;         // Compact once the journal has this many
+    bool replaying = false;       // True while applying journal records
+
+    std::thread compaction;
+    std::atomic<bool> compaction_running{false};
+
+public:
+    // A data file written by this class ends with an index (see
+    // IndexedStudentFile): then only the index is read here, and at most
+    // 'cache_capacity' unchanged records are kept in memory. Other files
+    // are loaded completely.
+    StudentManagementSystem(const std::string& data_file, size_t compact_after_records = 10000,
+                            size_t cache_capacity = 4096)
+        : file_manager(data_file),
+          journal_path(data_file + ".journal"),
+          rotated_journal_path(data_file + ".journal.old"),
+          journal(journal_path),
+          compact_after(compact_after_records) {
+        bool opened_lazily = false;
+        if (IndexedStudentFile::has_index(data_file)) {
+            try {
+                size_t duplicates = students.attach(std::make_unique<IndexedStudentFile>(data_file), cache_capacity);
+                if (duplicates > 0) {
+                    std::cerr << "Warning: Skipped " << duplicates << " duplicate student IDs\n";
+                }
+                std::cout << "Opened " << students.size() << " students (index only).\n";
+                opened_lazily = true;
+            } catch (const std::exception& e) {
+                std::cerr << "Warning: Ignoring the file's index: " << e.what() << "\n";
+            }
+        }
+        try {
+            if (!opened_lazily) {
+                size_t duplicates = students.insert_all(file_manager.load_students());
+                if (duplicates > 0) {
+                    std::cerr << "Warning: Skipped " << duplicates << " duplicate student IDs\n";
+                }
+                std::cout << "Loaded " << students.size() << " students from file.\n";
+            }
+        } catch (const std::exception& e) {
+            std::cout << "Warning: Could not load existing data: "
+                      << e.what() << "\n";
+            std::cout << "Starting with empty student list.\n";
+        }
+
+        // Replay the changes made after the base file was written: first a
+        // journal left over from an interrupted compaction, then the active one
+        last_seq = file_manager.read_snapshot_seq();
+        size_t replayed = 0;
+        replaying = true;
+        for (const std::string& path : {rotated_journal_path, journal_path}) {
+            last_seq = StudentJournal::replay(path, last_seq, [&](char op, std::string_view data) {
+                try {
+                    apply_journal_record(op, data);
+                    ++replayed;
+                } catch (const std::exception& e) {
+                    std::cerr << "Warning: Skipping journal record: " << e.what() << "\n";
+                }
+            });
+        }
+        replaying = false;
+        journal_records = replayed;
+        if (replayed > 0) {
+            std::cout << "Replayed " << replayed << " journal records.\n";
+        }
+
+        // An interrupted compaction is finished right away
+        if (file_exists(rotated_journal_path)) {
+            compact_now();
+        }
+    }
+
+    // Every change is already in the journal, so there is nothing big to
+    // write here - shutdown is fast even for a huge roster
+    ~StudentManagementSystem() {
+        wait_for_compaction();
+        try {
+            if (!file_exists(file_manager_path())) {
+                compact_now();  // First run: create the base file
+                std::cout << "Saved " << students.size() << " students.\n";
+            }
+        } catch (const std::exception& e) {
+            std::cout << "Warning: Could not save data: "
+                      << e.what() << "\n";
+        }
+    }
+
+    StudentManagementSystem(const StudentManagementSystem&) = delete;
+    StudentManagementSystem& operator=(const StudentManagementSystem&) = delete;
+
+    // -------------------------------------------------------------------------
+    // Core operations: change the roster and journal the change. The menu
+    // functions below only read input and call these.
+    // -------------------------------------------------------------------------
+
+    void add_student_record(int id, const std::string& name) {
+        students.begin_command();
+        if (!students.insert(Student(id, name))) {
+            throw std::invalid_argument("Student with ID " + std::to_string(id) + " already exists");
+        }
+        log_change('A', std::to_string(id) + "," + name);
+    }
+
+    void remove_student_record(int id) {
+        students.begin_command();
+        if (!students.erase(id)) {
+            throw StudentNotFoundException("Student with ID " + std::to_string(id) + " not found");
+        }
+        log_change('R', std::to_string(id));
+    }
+
+    void add_grade_record(int id, double grade) {
+        students.begin_command();
+        if (!students.add_grade(id, grade)) {  // May throw InvalidGradeException
+            throw StudentNotFoundException("Student with ID " + std::to_string(id) + " not found");
+        }
+
+        // Shortest text that reads back as exactly the same double
+        char text[48];
+        char* end = std::to_chars(text, text + sizeof(text), id).ptr;
+        *end++ = ',';
+        end = std::to_chars(end, text + sizeof(text), grade).ptr;
+        log_change('G', std::string_view(text, static_cast<size_t>(end - text)));
+    }
+
+    // Rank queries (O(log n) each, see GpaRankIndex)
+    size_t gpa_rank(int id) const {
+        require_student(id);
+        return students.rank(id);
+    }
+
+    double gpa_percentile(int id) const {
+        require_student(id);
+        return students.percentile(id);
+    }
+
+    std::vector<Student> top_students(size_t n) const {
+        return students.top(n);
+    }
+
+    // The pointer stays valid until the next call on the system (in lazy
+    // mode the record may be dropped from memory after that)
+    const Student* find_student(int id) {
+        students.begin_command();
+        return students.find(id);
+    }
+
+    size_t cached_records() const { return students.cached_records(); }
+
+    std::vector<Student> get_students() const { return students.to_vector(); }
+
+    void wait_for_compaction() {
+        if (compaction.joinable()) compaction.join();
+    }
+
+    // -------------------------------------------------------------------------
+    // Batch mode: run commands from a file or pipe, one per line, without
+    // menus or prompts (e.g. to replay a recorded trace against a new build):
+    //
+    //     add <id> <name>      remove <id>      search <id>
+    //     grade <id> <grade>   rank <id>        top <n>
+    //
+    // Empty lines and lines starting with '#' are skipped. Results of
+    // search/rank/top go to 'results' (nullptr: discard them). A failing
+    // command is counted and reported, and the batch continues.
+    // -------------------------------------------------------------------------
+
+    BatchReport run_batch(std::istream& in, std::ostream* results = nullptr) {
+        enum CommandType { Add, Remove, Search, Grade, Rank, Top, Unknown, CommandTypeCount };
+        static const char* const names[CommandTypeCount] = {
+            "add", "remove", "search", "grade", "rank", "top", "unknown"};
+
+        BatchReport report;
+        report.commands.resize(CommandTypeCount);
+        for (int type = 0; type < CommandTypeCount; ++type) {
+            report.commands[type].name = names[type];
+        }
+
+        using clock = std::chrono::steady_clock;
+        auto batch_start = clock::now();
+        std::string line;
+        std::string output;  // Results of one command, written after timing it
+        size_t line_number = 0;
+
+        while (std::getline(in, line)) {
+            ++line_number;
+            std::string_view rest(line);
+            std::string_view command = next_token(rest);
+            if (command.empty() || command[0] == '#') continue;
+
+            int type = Unknown;
+            for (int t = 0; t < Unknown; ++t) {
+                if (command == names[t]) type = t;
+            }
+
+            students.begin_command();
+            output.clear();
+            auto start = clock::now();
+            try {
+                switch (type) {
+                    case Add: {
+                        int id = parse_number<int>(next_token(rest));
+                        add_student_record(id, std::string(trim(rest)));
+                        break;
+                    }
+                    case Remove:
+                        remove_student_record(last_number<int>(rest));
+                        break;
+                    case Search: {
+                        int id = last_number<int>(rest);
+                        require_student(id);
+                        if (results) output.append(find_student_by_id(id)->to_string()) += '\n';
+                        break;
+                    }
+                    case Grade: {
+                        int id = parse_number<int>(next_token(rest));
+                        add_grade_record(id, last_number<double>(rest));
+                        break;
+                    }
+                    case Rank: {
+                        int id = last_number<int>(rest);
+                        size_t rank = gpa_rank(id);
+                        if (results) {
+                            output.append(std::to_string(id)).append(" rank ").append(std::to_string(rank))
+                                  .append(" of ").append(std::to_string(students.size())) += '\n';
+                        }
+                        break;
+                    }
+                    case Top:
+                        students.for_each_top(last_number<size_t>(rest), [&](const Student& student) {
+                            if (results) output.append(student.to_string()) += '\n';
+                        });
+                        break;
+                    default:
+                        throw std::invalid_argument("Unknown command: " + std::string(command));
+                }
+            } catch (const std::exception& e) {
+                ++report.commands[type].failed;
+                ++report.failed;
+                if (report.first_errors.size() < 10) {
+                    report.first_errors.push_back("line " + std::to_string(line_number) + ": " + e.what());
+                }
+            }
+            report.commands[type].latencies_ns.push_back(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start).count());
+            ++report.total;
+            // Writing to 'results' (often a terminal) is not part of the command
+            if (results && !output.empty()) *results << output;
         }
+
+        report.seconds = std::chrono::duration<double>(clock::now() - batch_start).count();
+        return report;
     }
 
     void run() {
         int choice;
 
         do {
+            students.begin_command();
             display_menu();
             std::cout << "Enter choice: ";
 
@@ -575,6 +3037,12 @@ public:
                     case 5:
                         add_grade_to_student();
                         break;
+                    case 6:
+                        show_gpa_rank();
+                        break;
+                    case 7:
+                        show_top_students();
+                        break;
                     case 0:
                         std::cout << "Goodbye!\n";
                         break;
@@ -600,6 +3068,8 @@ private:
         std::cout << "3. Search Student\n";
         std::cout << "4. Display All Students\n";
         std::cout << "5. Add Grade to Student\n";
+        std::cout << "6. Show GPA Rank\n";
+        std::cout << "7. Show Top Students\n";
         std::cout << "0. Exit\n";
     }
 
@@ -611,17 +3081,15 @@ private:
         std::cin >> id;
         std::cin.ignore(10000, '\n');
 
-        // Check if ID already exists
-        for (const auto& student : students) {
-            if (student.get_id() == id) {
-                throw std::invalid_argument("Student with ID " + std::to_string(id) + " already exists");
-            }
+        // Check if ID already exists (before asking for the name)
+        if (find_student_by_id(id)) {
+            throw std::invalid_argument("Student with ID " + std::to_string(id) + " already exists");
         }
 
         std::cout << "Enter student name: ";
         std::getline(std::cin, name);
 
-        students.push_back(Student(id, name));
+        add_student_record(id, name);
         std::cout << "Student added successfully!\n";
     }
 
@@ -630,16 +3098,8 @@ private:
         std::cout << "Enter student ID to remove: ";
         std::cin >> id;
 
-        // Find and remove student
-        auto it = std::find_if(students.begin(), students.end(),
-            [id](const Student& s) { return s.get_id() == id; });
-
-        if (it != students.end()) {
-            students.erase(it);
-            std::cout << "Student removed successfully!\n";
-        } else {
-            throw StudentNotFoundException("Student with ID " + std::to_string(id) + " not found");
-        }
+        remove_student_record(id);  // Throws StudentNotFoundException if missing
+        std::cout << "Student removed successfully!\n";
     }
 
     void search_student() {
@@ -647,7 +3107,7 @@ private:
         std::cout << "Enter student ID to search: ";
         std::cin >> id;
 
-        Student* student = find_student_by_id(id);
+        const Student* student = find_student_by_id(id);
         if (student) {
             student->display();
         } else {
@@ -662,10 +3122,7 @@ private:
         }
 
         std::cout << "\n=== All Students ===\n";
-        // Use range-based for loop to iterate
-        for (const auto& student : students) {
-            student.display();
-        }
+        students.for_each([](const Student& student) { student.display(); });
     }
 
     void add_grade_to_student() {
@@ -678,26 +3135,995 @@ private:
         std::cout << "Enter grade (0-100): ";
         std::cin >> grade;
 
-        Student* student = find_student_by_id(id);
-        if (student) {
-            student->add_grade(grade);  // May throw InvalidGradeException
-            std::cout << "Grade added successfully!\n";
-        } else {
+        add_grade_record(id, grade);  // May throw StudentNotFoundException or InvalidGradeException
+        std::cout << "Grade added successfully!\n";
+    }
+
+    void show_gpa_rank() {
+        int id;
+        std::cout << "Enter student ID: ";
+        std::cin >> id;
+
+        size_t rank = gpa_rank(id);  // Throws StudentNotFoundException if missing
+        std::cout << "Rank " << rank << " of " << students.size()
+                  << " (GPA higher than " << gpa_percentile(id) << "% of students)\n";
+    }
+
+    void show_top_students() {
+        int count;
+        std::cout << "How many students? ";
+        std::cin >> count;
+        if (count <= 0) {
+            throw std::invalid_argument("Count must be positive");
+        }
+
+        std::cout << "\n=== Top " << count << " Students by GPA ===\n";
+        for (const Student& student : top_students(static_cast<size_t>(count))) {
+            student.display();
+        }
+    }
+
+    // Helper function to find student by ID (O(1): hash index)
+    const Student* find_student_by_id(int id) const {
+        return students.find(id);
+    }
+
+    void require_student(int id) const {
+        if (!students.contains(id)) {
             throw StudentNotFoundException("Student with ID " + std::to_string(id) + " not found");
         }
     }
 
-    // Helper function to find student by ID
-    Student* find_student_by_id(int id) {
-        for (auto& student : students) {
-            if (student.get_id() == id) {
-                return &student;
+    const std::string& file_manager_path() const {
+        return file_manager.get_filename();
+    }
+
+    // Batch mode parsing helpers
+    // -------------------------------------------------------------------------
+
+    static std::string_view trim(std::string_view text) {
+        while (!text.empty() && std::isspace(static_cast<unsigned char>(text.front()))) text.remove_prefix(1);
+        while (!text.empty() && std::isspace(static_cast<unsigned char>(text.back()))) text.remove_suffix(1);
+        return text;
+    }
+
+    // Cuts the first space-separated word off 'rest' and returns it
+    static std::string_view next_token(std::string_view& rest) {
+        rest = trim(rest);
+        size_t end = 0;
+        while (end < rest.size() && !std::isspace(static_cast<unsigned char>(rest[end]))) ++end;
+        std::string_view token = rest.substr(0, end);
+        rest.remove_prefix(end);
+        return token;
+    }
+
+    // The whole token must be a number. from_chars also reads "nan" and
+    // "inf", which cin >> grade never accepts - so they are rejected here.
+    template<typename T>
+    static T parse_number(std::string_view token) {
+        T value{};
+        const char* last = token.data() + token.size();
+        std::from_chars_result result = std::from_chars(token.data(), last, value);
+        bool finite = true;
+        if constexpr (std::is_floating_point_v<T>) finite = std::isfinite(value);
+        if (token.empty() || result.ec != std::errc() || result.ptr != last || !finite) {
+            throw std::invalid_argument("Invalid number: '" + std::string(token) + "'");
+        }
+        return value;
+    }
+
+    // The next token must be a number, and the last thing on the line
+    template<typename T>
+    static T last_number(std::string_view& rest) {
+        T value = parse_number<T>(next_token(rest));
+        if (!trim(rest).empty()) {
+            throw std::invalid_argument("Unexpected text: '" + std::string(trim(rest)) + "'");
+        }
+        return value;
+    }
+
+    // Journal helpers
+    // -------------------------------------------------------------------------
+
+    void log_change(char op, std::string_view data) {
+        if (replaying) return;  // Replayed records are in the journal already
+        journal.append(++last_seq, op, data);
+        if (++journal_records >= compact_after) {
+            start_compaction();
+        }
+    }
+
+    void apply_journal_record(char op, std::string_view data) {
+        size_t comma = data.find(',');
+        int id = std::stoi(std::string(data.substr(0, comma)));
+        switch (op) {
+            case 'A':
+                add_student_record(id, std::string(data.substr(comma + 1)));
+                break;
+            case 'R':
+                remove_student_record(id);
+                break;
+            case 'G':
+                add_grade_record(id, std::stod(std::string(data.substr(comma + 1))));
+                break;
+            default:
+                throw std::runtime_error("Unknown journal operation: " + std::string(1, op));
+        }
+    }
+
+    // Compaction in the background:
+    // 1. (this thread) move the journal aside and start a fresh one -
+    //    nothing else, so the change that triggers compaction stays fast
+    // 2. (background thread) build the new base file from the OLD base
+    //    file and the journal that was moved aside: unchanged students are
+    //    streamed from the old file, only the students named in the journal
+    //    are kept in memory. The roster itself is not touched, so there is
+    //    no copy and no locking. Then delete the old journal.
+    // A crash at any point is safe: until the new base file is in place,
+    // the old base + both journals still describe everything.
+    // In lazy mode the roster keeps reading records from the file it
+    // opened: on POSIX systems an open file stays readable after rename()
+    // replaces it, and its unchanged records are still correct.
+    void start_compaction() {
+        if (compaction_running) return;  // The previous one is still writing
+        wait_for_compaction();
+        if (file_exists(rotated_journal_path)) return;  // A failed compaction left it; retried at next startup
+
+        journal.rotate(rotated_journal_path);
+        journal_records = 0;
+        long long snapshot_seq = last_seq;
+
+        compaction_running = true;
+        compaction = std::thread([this, snapshot_seq]() {
+            try {
+                merge_journal_into_base(file_manager_path(), rotated_journal_path, snapshot_seq);
+                std::remove(rotated_journal_path.c_str());
+            } catch (const std::exception& e) {
+                std::cerr << "Warning: Compaction failed: " << e.what() << "\n";
+            }
+            compaction_running = false;
+        });
+    }
+
+    // Writes base file + journal records as a new base file with "#seq
+    // snapshot_seq" and an index. Memory use depends on the number of
+    // students in the journal, not on the size of the roster.
+    static void merge_journal_into_base(const std::string& base_path, const std::string& journal_path,
+                                        long long snapshot_seq) {
+        // What the journal did to one student
+        struct JournalChange {
+            bool replaces_base = false;  // Removed (maybe added again): ignore the base record
+            bool exists = true;
+            std::string name;            // Only used if replaces_base
+            std::vector<double> new_grades;
+        };
+        std::unordered_map<int, JournalChange> changes;
+
+        StudentFileManager base(base_path);
+        bool has_base = file_exists(base_path);
+        StudentJournal::replay(journal_path, has_base ? base.read_snapshot_seq() : 0,
+                               [&](char op, std::string_view data) {
+            try {
+                size_t comma = data.find(',');
+                int id = std::stoi(std::string(data.substr(0, comma)));
+                JournalChange& change = changes[id];
+                switch (op) {
+                    case 'A':
+                        change.replaces_base = true;
+                        change.exists = true;
+                        change.name = std::string(data.substr(comma + 1));
+                        change.new_grades.clear();
+                        break;
+                    case 'R':
+                        change.replaces_base = true;
+                        change.exists = false;
+                        change.new_grades.clear();
+                        break;
+                    case 'G':
+                        change.new_grades.push_back(std::stod(std::string(data.substr(comma + 1))));
+                        break;
+                    default:
+                        throw std::runtime_error("Unknown journal operation: " + std::string(1, op));
+                }
+            } catch (const std::exception& e) {
+                std::cerr << "Warning: Skipping journal record: " << e.what() << "\n";
             }
+        });
+
+        // Students added by the journal go after the base file's, by id
+        std::vector<int> added;
+        for (const auto& entry : changes) {
+            if (entry.second.replaces_base && entry.second.exists) added.push_back(entry.first);
         }
-        return nullptr;
+        std::sort(added.begin(), added.end());
+
+        StudentFileManager(base_path).save_students_from([&](auto&& emit) {
+            if (has_base) {
+                base.for_each_student([&](const Student& student) {
+                    auto found = changes.find(student.get_id());
+                    if (found == changes.end()) {
+                        emit(student);  // Unchanged: straight from the old file
+                    } else if (!found->second.replaces_base) {
+                        Student changed = student;
+                        changed.add_grades(found->second.new_grades.data(), found->second.new_grades.size());
+                        emit(changed);
+                    }
+                });
+            }
+            for (int id : added) {
+                const JournalChange& change = changes[id];
+                Student student(id, change.name);
+                student.add_grades(change.new_grades.data(), change.new_grades.size());
+                emit(student);
+            }
+        }, snapshot_seq, true);
+    }
+
+    // Same result, on this thread
+    void compact_now() {
+        file_manager.save_students(students.to_vector(), last_seq, true);
+        std::remove(rotated_journal_path.c_str());
+        journal.clear();
+        journal_records = 0;
     }
 };
 
+// -----------------------------------------------------------------------------
+// Performance: Student Text Codec
+// -----------------------------------------------------------------------------
+
+// The original stream-based versions of to_string/from_string, kept here
+// only so the benchmark can compare against them
+namespace legacy_codec {
+
+std::string to_string(const Student& student) {
+    std::ostringstream oss;
+    oss << student.get_id() << "," << student.get_name();
+    for (const auto& grade : student.get_grades()) {
+        oss << "," << grade;
+    }
+    return oss.str();
+}
+
+Student from_string(const std::string& str) {
+    std::istringstream iss(str);
+    std::string token;
+
+    std::getline(iss, token, ',');
+    int id = std::stoi(token);
+
+    std::string name;
+    std::getline(iss, name, ',');
+
+    Student student(id, name);
+    while (std::getline(iss, token, ',')) {
+        student.add_grade(std::stod(token));
+    }
+    return student;
+}
+
+}  // namespace legacy_codec
+
+void student_codec_benchmark() {
+    std::cout << "\n=== Performance: Student Text Codec ===\n";
+
+    const int count = 200000;
+    std::vector<Student> students;
+    students.reserve(count);
+    unsigned long long state = 2024;
+    for (int i = 0; i < count; ++i) {
+        Student student(100000 + i, "Student " + std::to_string(i));
+        for (int g = 0; g < 6; ++g) {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            student.add_grade(static_cast<double>((state >> 33) % 1001) / 10.0);  // 0.0 - 100.0
+        }
+        students.push_back(student);
+    }
+
+    using clock = std::chrono::steady_clock;
+    auto to_ms = [](clock::duration d) {
+        return std::chrono::duration<double, std::milli>(d).count();
+    };
+
+    // Serialize: ostringstream per line vs. to_chars into one buffer
+    auto start = clock::now();
+    std::string legacy_text;
+    for (const auto& student : students) {
+        legacy_text += legacy_codec::to_string(student);
+        legacy_text += '\n';
+    }
+    auto legacy_write = clock::now() - start;
+
+    start = clock::now();
+    std::string codec_text;
+    std::vector<char> line(256);
+    for (const auto& student : students) {
+        if (line.size() < student.serialized_size_bound()) line.resize(student.serialized_size_bound());
+        std::to_chars_result result = student.serialize_to(line.data(), line.data() + line.size());
+        codec_text.append(line.data(), result.ptr);
+        codec_text += '\n';
+    }
+    auto codec_write = clock::now() - start;
+
+    // Parse: istringstream + stoi/stod vs. from_chars into a reused Student
+    std::vector<std::string> lines;
+    std::istringstream split(legacy_text);
+    for (std::string l; std::getline(split, l);) lines.push_back(l);
+
+    start = clock::now();
+    double legacy_sum = 0.0;
+    for (const auto& l : lines) {
+        legacy_sum += legacy_codec::from_string(l).calculate_gpa();
+    }
+    auto legacy_read = clock::now() - start;
+
+    start = clock::now();
+    double codec_sum = 0.0;
+    Student scratch(0, "");  // Its name and grade storage is reused every line
+    for (const auto& l : lines) {
+        Student::parse_into(l, scratch);
+        codec_sum += scratch.calculate_gpa();
+    }
+    auto codec_read = clock::now() - start;
+
+    std::cout << count << " students:\n";
+    std::cout << "  serialize, ostringstream:       " << to_ms(legacy_write) << " ms\n";
+    std::cout << "  serialize, to_chars:            " << to_ms(codec_write) << " ms\n";
+    std::cout << "  parse, istringstream + stod:    " << to_ms(legacy_read) << " ms\n";
+    std::cout << "  parse, from_chars (parse_into): " << to_ms(codec_read) << " ms\n";
+    std::cout << "  identical text: " << (legacy_text == codec_text ? "yes" : "NO")
+              << ", identical GPA sum: " << (legacy_sum == codec_sum ? "yes" : "NO") << "\n";
+
+    // Validation is unchanged: the same lines are rejected the same way
+    const char* bad_lines[] = {"abc,Name,90", "7,Name,150", "8,Name,,90", "9,Name,9x"};
+    for (const char* bad : bad_lines) {
+        try {
+            Student s = Student::from_string(bad);
+            std::cout << "  \"" << bad << "\" -> accepted: " << s.to_string() << "\n";
+        } catch (const InvalidGradeException& e) {
+            std::cout << "  \"" << bad << "\" -> InvalidGradeException: " << e.what() << "\n";
+        } catch (const std::exception& e) {
+            std::cout << "  \"" << bad << "\" -> " << e.what() << "\n";
+        }
+    }
+}
+
+void student_loader_benchmark() {
+    std::cout << "\n=== Performance: Parallel and Streaming Student Loader ===\n";
+
+    const std::string filename = "roster_large.txt";
+    const int count = 500000;
+    {
+        std::vector<Student> roster;
+        roster.reserve(count);
+        for (int i = 0; i < count; ++i) {
+            Student student(i + 1, "Student " + std::to_string(i));
+            for (int g = 0; g < 5; ++g) student.add_grade((i * 7 + g * 13) % 101);
+            roster.push_back(student);
+        }
+        StudentFileManager(filename).save_students(roster);
+    }
+    {
+        std::ofstream append(filename, std::ios::app);
+        append << "not-a-number,Broken Line,90\n";  // Still reported as a warning
+    }
+
+    using clock = std::chrono::steady_clock;
+    auto to_ms = [](clock::duration d) {
+        return std::chrono::duration<double, std::milli>(d).count();
+    };
+
+    StudentFileManager manager(filename);
+
+    auto start = clock::now();
+    std::vector<Student> one_thread = manager.load_students(1);
+    auto single_time = clock::now() - start;
+
+    start = clock::now();
+    std::vector<Student> parallel = manager.load_students();
+    auto parallel_time = clock::now() - start;
+
+    bool same_order = one_thread.size() == parallel.size();
+    for (size_t i = 0; same_order && i < parallel.size(); ++i) {
+        same_order = one_thread[i].get_id() == parallel[i].get_id();
+    }
+
+    start = clock::now();
+    double gpa_total = 0.0;
+    size_t streamed = manager.for_each_student([&gpa_total](const Student& student) {
+        gpa_total += student.calculate_gpa();
+    });
+    auto stream_time = clock::now() - start;
+
+    std::cout << count << " students (" << std::thread::hardware_concurrency() << " hardware threads):\n";
+    std::cout << "  load_students(1):        " << to_ms(single_time) << " ms\n";
+    std::cout << "  load_students():         " << to_ms(parallel_time) << " ms, same order: "
+              << (same_order ? "yes" : "NO") << "\n";
+    std::cout << "  for_each_student():      " << to_ms(stream_time) << " ms, " << streamed
+              << " students, average GPA " << gpa_total / static_cast<double>(streamed) << "\n";
+    std::cout << "  (streaming keeps only one block in memory, whatever the file size)\n";
+
+    std::remove(filename.c_str());
+}
+
+void journal_persistence_demo() {
+    std::cout << "\n=== Performance: Journaled Persistence ===\n";
+
+    const std::string filename = "journal_demo.txt";
+    auto remove_files = [&filename]() {
+        std::remove(filename.c_str());
+        std::remove((filename + ".tmp").c_str());
+        std::remove((filename + ".journal").c_str());
+        std::remove((filename + ".journal.old").c_str());
+    };
+    remove_files();
+
+    const int count = 200000;
+    {
+        std::vector<Student> roster;
+        roster.reserve(count);
+        for (int i = 0; i < count; ++i) {
+            Student student(i + 1, "Student " + std::to_string(i));
+            for (int g = 0; g < 5; ++g) student.add_grade((i * 7 + g * 13) % 101);
+            roster.push_back(student);
+        }
+        StudentFileManager(filename).save_students(roster, 0);
+    }
+
+    using clock = std::chrono::steady_clock;
+    auto to_ms = [](clock::duration d) {
+        return std::chrono::duration<double, std::milli>(d).count();
+    };
+
+    const int changes = 20000;
+    {
+        StudentManagementSystem system(filename, 15000);
+
+        // The old way: every save rewrites the whole roster
+        auto start = clock::now();
+        StudentFileManager(filename + ".tmp").save_students(system.get_students());
+        auto full_save_time = clock::now() - start;
+        std::remove((filename + ".tmp").c_str());
+
+        // The journal: every change appends one line (with a compaction
+        // in the background after 15000 of them)
+        start = clock::now();
+        for (int i = 0; i < changes; ++i) {
+            system.add_grade_record(i * 7 % count + 1, 50.0 + (i % 500) / 10.0);
+        }
+        auto journal_time = clock::now() - start;
+        system.add_student_record(count + 1, "Newcomer");
+        system.remove_student_record(1);
+        system.wait_for_compaction();
+
+        std::cout << count << " students:\n";
+        std::cout << "  one full save:          " << to_ms(full_save_time) << " ms\n";
+        std::cout << "  " << changes << " journaled changes: " << to_ms(journal_time) << " ms ("
+                  << to_ms(journal_time) * 1000.0 / changes << " us per change)\n";
+
+        // Open the same data a second time WITHOUT the first system shutting
+        // down - as if it had crashed. Base file + journal replay restore
+        // every change.
+        std::cout << "\nReopening while the first system is still running:\n";
+        StudentManagementSystem reopened(filename);
+        std::vector<Student> original = system.get_students();
+        bool same = original.size() == reopened.get_students().size();
+        for (size_t i = 0; same && i < original.size(); ++i) {
+            const Student* copy = reopened.find_student(original[i].get_id());
+            same = copy && copy->to_string() == original[i].to_string();
+        }
+        std::cout << "  same roster after replay: " << (same ? "yes" : "NO") << "\n";
+    }
+
+    remove_files();
+}
+
+void student_index_benchmark() {
+    std::cout << "\n=== Performance: Indexed Student Roster ===\n";
+
+    const int count = 200000;
+    const int queries = 2000;
+    std::vector<Student> list;  // The old layout: one vector, linear scans
+    StudentRoster roster;
+    list.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        Student student(i + 1, "Student " + std::to_string(i));
+        for (int g = 0; g < 3; ++g) student.add_grade((i * 7 + g * 13) % 101);
+        list.push_back(student);
+        roster.insert(student);
+    }
+
+    std::vector<int> ids(queries);
+    for (int i = 0; i < queries; ++i) ids[i] = (i * 7919) % count + 1;
+
+    using clock = std::chrono::steady_clock;
+    auto to_us = [](clock::duration d) {
+        return std::chrono::duration<double, std::micro>(d).count();
+    };
+    auto find_in_list = [&list](int id) {
+        return std::find_if(list.begin(), list.end(),
+            [id](const Student& s) { return s.get_id() == id; });
+    };
+
+    // Rank = 1 + number of students with a higher GPA
+    auto start = clock::now();
+    size_t list_rank_total = 0;
+    for (int id : ids) {
+        double gpa = find_in_list(id)->calculate_gpa();
+        list_rank_total += 1 + std::count_if(list.begin(), list.end(),
+            [gpa](const Student& s) { return s.calculate_gpa() > gpa; });
+    }
+    auto list_rank_time = clock::now() - start;
+
+    start = clock::now();
+    size_t roster_rank_total = 0;
+    for (int id : ids) roster_rank_total += roster.rank(id);
+    auto roster_rank_time = clock::now() - start;
+
+    // Top 10 by GPA
+    start = clock::now();
+    std::vector<const Student*> list_top(list.size());
+    for (size_t i = 0; i < list.size(); ++i) list_top[i] = &list[i];
+    std::partial_sort(list_top.begin(), list_top.begin() + 10, list_top.end(),
+        [](const Student* a, const Student* b) {
+            double ga = a->calculate_gpa(), gb = b->calculate_gpa();
+            return ga > gb || (ga == gb && a->get_id() < b->get_id());
+        });
+    list_top.resize(10);
+    auto list_top_time = clock::now() - start;
+
+    start = clock::now();
+    std::vector<Student> roster_top = roster.top(10);
+    auto roster_top_time = clock::now() - start;
+
+    bool same_top = true;
+    for (size_t i = 0; i < 10; ++i) {
+        same_top = same_top && list_top[i]->get_id() == roster_top[i].get_id();
+    }
+
+    // Remove: find, then erase (vector::erase shifts everything behind it)
+    start = clock::now();
+    for (int id : ids) {
+        auto it = find_in_list(id);
+        if (it != list.end()) list.erase(it);
+    }
+    auto list_erase_time = clock::now() - start;
+
+    start = clock::now();
+    for (int id : ids) roster.erase(id);
+    auto roster_erase_time = clock::now() - start;
+
+    std::cout << count << " students, " << queries << " queries of each kind (time per query):\n";
+    std::cout << "                      vector + scan     StudentRoster\n";
+    std::cout << "  rank:               " << to_us(list_rank_time) / queries << " us   \t"
+              << to_us(roster_rank_time) / queries << " us\n";
+    std::cout << "  top 10:             " << to_us(list_top_time) << " us   \t"
+              << to_us(roster_top_time) << " us (one query)\n";
+    std::cout << "  remove:             " << to_us(list_erase_time) / queries << " us   \t"
+              << to_us(roster_erase_time) / queries << " us\n";
+    std::cout << "  same ranks: " << (list_rank_total == roster_rank_total ? "yes" : "NO")
+              << ", same top 10: " << (same_top ? "yes" : "NO")
+              << ", same size: " << (list.size() == roster.size() ? "yes" : "NO") << "\n";
+}
+
+void gpa_report_benchmark() {
+    std::cout << "\n=== Performance: Incremental GPA ===\n";
+
+    const int count = 100000;
+    const int grades_per_student = 20;
+
+    // The grades of all students in one array, as a bulk import would read them
+    std::vector<double> all_grades(static_cast<size_t>(count) * grades_per_student);
+    for (size_t i = 0; i < all_grades.size(); ++i) {
+        all_grades[i] = static_cast<double>((i * 37) % 1001) / 10.0;
+    }
+
+    using clock = std::chrono::steady_clock;
+    auto to_ms = [](clock::duration d) {
+        return std::chrono::duration<double, std::milli>(d).count();
+    };
+
+    // Import: one add_grade() per grade vs one add_grades() per student
+    std::vector<Student> one_by_one;
+    std::vector<Student> batched;
+    one_by_one.reserve(count);
+    batched.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        one_by_one.emplace_back(i + 1, "Student");
+        batched.emplace_back(i + 1, "Student");
+    }
+
+    auto start = clock::now();
+    for (int i = 0; i < count; ++i) {
+        const double* grades = &all_grades[static_cast<size_t>(i) * grades_per_student];
+        for (int g = 0; g < grades_per_student; ++g) one_by_one[i].add_grade(grades[g]);
+    }
+    auto single_time = clock::now() - start;
+
+    start = clock::now();
+    for (int i = 0; i < count; ++i) {
+        batched[i].add_grades(&all_grades[static_cast<size_t>(i) * grades_per_student], grades_per_student);
+    }
+    auto batch_time = clock::now() - start;
+
+    // Report: every student's GPA, 10 times (like 10 printed reports).
+    // The old calculate_gpa() walked all grades through the if-else chain.
+    auto old_gpa = [](const Student& student) {
+        const std::vector<double>& grades = student.get_grades();
+        if (grades.empty()) return 0.0;
+        double sum = 0.0;
+        for (double grade : grades) {
+            if (grade >= 90) sum += 4.0;
+            else if (grade >= 80) sum += 3.0;
+            else if (grade >= 70) sum += 2.0;
+            else if (grade >= 60) sum += 1.0;
+        }
+        return sum / grades.size();
+    };
+
+    const int reports = 10;
+    start = clock::now();
+    double old_total = 0.0;
+    for (int r = 0; r < reports; ++r) {
+        for (const Student& student : batched) old_total += old_gpa(student);
+    }
+    auto old_report_time = clock::now() - start;
+
+    start = clock::now();
+    double new_total = 0.0;
+    for (int r = 0; r < reports; ++r) {
+        for (const Student& student : batched) new_total += student.calculate_gpa();
+    }
+    auto new_report_time = clock::now() - start;
+
+    bool same = true;
+    for (int i = 0; i < count && same; ++i) {
+        same = one_by_one[i].calculate_gpa() == old_gpa(one_by_one[i]) &&
+               batched[i].calculate_gpa() == old_gpa(batched[i]);
+    }
+
+    std::cout << count << " students x " << grades_per_student << " grades:\n";
+    std::cout << "  import, add_grade() each:      " << to_ms(single_time) << " ms\n";
+    std::cout << "  import, add_grades() batch:    " << to_ms(batch_time) << " ms\n";
+    std::cout << "  " << reports << " reports, recomputed GPA: " << to_ms(old_report_time) << " ms\n";
+    std::cout << "  " << reports << " reports, kept GPA:       " << to_ms(new_report_time) << " ms\n";
+    std::cout << "  same GPAs: " << (same && old_total == new_total ? "yes" : "NO") << "\n";
+}
+
+// Runs a command file (or standard input for "-") in batch mode:
+// results on standard output, the timing report on standard error
+int run_batch_file(const std::string& commands_path, const std::string& data_file) {
+    std::ifstream file;
+    if (commands_path != "-") {
+        file.open(commands_path);
+        if (!file.is_open()) {
+            std::cerr << "Failed to open command file: " << commands_path << "\n";
+            return 1;
+        }
+    }
+    std::istream& in = commands_path == "-" ? std::cin : file;
+
+    StudentManagementSystem system(data_file);
+    BatchReport report = system.run_batch(in, &std::cout);
+    report.print(std::cerr);
+    return 0;
+}
+
+void batch_command_benchmark() {
+    std::cout << "\n=== Performance: Batch Commands ===\n";
+
+    const std::string trace_name = "batch_trace.txt";
+    const std::string data_file = "batch_demo.txt";
+    auto remove_files = [&]() {
+        std::remove(trace_name.c_str());
+        for (const char* suffix : {"", ".tmp", ".journal", ".journal.old"}) {
+            std::remove((data_file + suffix).c_str());
+        }
+    };
+    remove_files();
+
+    // A trace like a busy term: enroll students, record grades, look
+    // students up, check ranks, drop some students
+    const int count = 50000;
+    {
+        std::ofstream trace(trace_name);
+        trace << "# generated trace\n";
+        for (int i = 1; i <= count; ++i) trace << "add " << i << " Student " << i << "\n";
+        for (int i = 0; i < 4 * count; ++i) {
+            trace << "grade " << (i * 7919) % count + 1 << " " << (i * 37) % 1001 / 10.0 << "\n";
+            if (i % 4 == 0) trace << "search " << (i * 31) % count + 1 << "\n";
+            if (i % 20 == 0) trace << "rank " << (i * 17) % count + 1 << "\n";
+            if (i % 2000 == 0) trace << "top 10\n";
+        }
+        for (int i = 1; i <= count; i += 10) trace << "remove " << i << "\n";
+        trace << "grade 1 90\n";        // Removed above: fails
+        trace << "grade 2 abc\n";       // Not a number: fails
+        trace << "rename 3 Someone\n";  // Unknown command: fails
+    }
+
+    {
+        StudentManagementSystem system(data_file, 1000000);  // No compaction during the run
+        std::ifstream trace(trace_name);
+        std::ostringstream results;
+        BatchReport report = system.run_batch(trace, &results);
+        report.print(std::cout);
+        std::cout << "(" << results.str().size() << " bytes of results; every add/grade/remove "
+                  << "also appends to the journal)\n";
+    }
+
+    remove_files();
+}
+
+void dirty_data_benchmark() {
+    std::cout << "\n=== Performance: Loading Dirty Data ===\n";
+
+    // Two files of 200000 lines: one clean, one where half the lines are
+    // broken (bad IDs, bad grades, grades over 100)
+    const int count = 200000;
+    const char* broken[] = {"x17,Name,90", "17,Name,o9", "17,Name,105", "99999999999,Name,80"};
+    std::string clean_text, dirty_text;
+    for (int i = 0; i < count; ++i) {
+        std::string line = std::to_string(i + 1) + ",Student " + std::to_string(i) + ",85.5,91,77\n";
+        clean_text += line;
+        dirty_text += i % 2 == 0 ? line : std::string(broken[i / 2 % 4]) + "\n";
+    }
+
+    using clock = std::chrono::steady_clock;
+    auto to_ms = [](clock::duration d) {
+        return std::chrono::duration<double, std::milli>(d).count();
+    };
+
+    // Both ways read the file first, then parse every line
+    const std::string filename = "dirty_data.txt";
+
+    // The exception way: parse_into() and one try/catch per line
+    auto with_exceptions = [&filename](size_t& bad) {
+        std::ifstream file(filename);
+        std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        std::vector<Student> students;
+        Student scratch(0, "");
+        bad = 0;
+        size_t pos = 0;
+        while (pos < text.size()) {
+            size_t end = text.find('\n', pos);
+            try {
+                Student::parse_into(std::string_view(text).substr(pos, end - pos), scratch);
+                students.push_back(scratch);
+            } catch (const std::exception&) {
+                ++bad;
+            }
+            pos = end + 1;
+        }
+        return students.size();
+    };
+
+    auto with_error_codes = [&filename](size_t& bad) {
+        std::vector<LineDiagnostic> diagnostics;
+        size_t good = StudentFileManager(filename).load_students(diagnostics, 1).size();
+        bad = diagnostics.size();
+        return good;
+    };
+
+    for (int dirty = 0; dirty <= 1; ++dirty) {
+        { std::ofstream(filename) << (dirty ? dirty_text : clean_text); }
+        size_t bad_exceptions = 0, bad_codes = 0;
+
+        auto start = clock::now();
+        size_t good_exceptions = with_exceptions(bad_exceptions);
+        auto exception_time = clock::now() - start;
+
+        start = clock::now();
+        size_t good_codes = with_error_codes(bad_codes);
+        auto code_time = clock::now() - start;
+
+        std::cout << (dirty ? "Dirty file" : "Clean file") << " (" << bad_codes << " bad lines):\n";
+        std::cout << "  try/catch per line:         " << to_ms(exception_time) << " ms\n";
+        std::cout << "  load_students(diagnostics): " << to_ms(code_time) << " ms\n";
+        std::cout << "  same result: "
+                  << (good_exceptions == good_codes && bad_exceptions == bad_codes ? "yes" : "NO") << "\n";
+    }
+
+    // What the caller gets for each bad line
+    std::vector<LineDiagnostic> diagnostics;
+    { std::ofstream(filename) << "1,Ann,90\nx2,Bob,80\n3,Cy,o9\n4,Di,105\n"; }
+    StudentFileManager(filename).load_students(diagnostics);
+    std::cout << "\nDiagnostics for a small file:\n";
+    for (const LineDiagnostic& d : diagnostics) {
+        std::cout << "  line " << d.line_number << ", column " << d.error.column + 1 << ": "
+                  << d.error.message() << "  [" << d.text << "]\n";
+    }
+    std::remove(filename.c_str());
+}
+
+void lazy_loading_benchmark() {
+    std::cout << "\n=== Performance: Lazy Loading with an Index ===\n";
+
+    const std::string plain_file = "lazy_plain.txt";
+    const std::string indexed_file = "lazy_indexed.txt";
+    auto remove_files = [&]() {
+        for (const std::string& name : {plain_file, indexed_file}) {
+            for (const char* suffix : {"", ".tmp", ".journal", ".journal.old"}) {
+                std::remove((name + suffix).c_str());
+            }
+        }
+    };
+    remove_files();
+
+    const int count = 500000;
+    {
+        std::vector<Student> roster;
+        roster.reserve(count);
+        for (int i = 0; i < count; ++i) {
+            Student student(i + 1, "Student " + std::to_string(i));
+            for (int g = 0; g < 5; ++g) student.add_grade((i * 7 + g * 13) % 101);
+            roster.push_back(student);
+        }
+        StudentFileManager(plain_file).save_students(roster, 0);
+        StudentFileManager(indexed_file).save_students(roster, 0, true);
+    }
+
+    using clock = std::chrono::steady_clock;
+    auto to_ms = [](clock::duration d) {
+        return std::chrono::duration<double, std::milli>(d).count();
+    };
+
+    // A typical session: open, look at a few hundred students, close
+    const int lookups = 500;
+    auto session = [&](const std::string& file, double& open_ms, double& lookup_ms, size_t& cached) {
+        auto start = clock::now();
+        StudentManagementSystem system(file, 10000, 100);
+        open_ms = to_ms(clock::now() - start);
+
+        start = clock::now();
+        double gpa_total = 0.0;
+        for (int i = 0; i < lookups; ++i) {
+            int id = (i * 7919) % count + 1;
+            gpa_total += system.find_student(id)->calculate_gpa() + system.gpa_rank(id);
+        }
+        lookup_ms = to_ms(clock::now() - start);
+        cached = system.cached_records();
+        return gpa_total;
+    };
+
+    double plain_open, plain_lookup, indexed_open, indexed_lookup;
+    size_t plain_cached, indexed_cached;
+    double plain_result = session(plain_file, plain_open, plain_lookup, plain_cached);
+    double indexed_result = session(indexed_file, indexed_open, indexed_lookup, indexed_cached);
+
+    std::cout << count << " students, " << lookups << " lookups + rank queries:\n";
+    std::cout << "  load everything:   open " << plain_open << " ms, lookups " << plain_lookup << " ms\n";
+    std::cout << "  index only (lazy): open " << indexed_open << " ms, lookups " << indexed_lookup
+              << " ms, " << indexed_cached << " records in memory (limit 100)\n";
+    std::cout << "  same answers: " << (plain_result == indexed_result ? "yes" : "NO") << "\n";
+
+    remove_files();
+}
+
+// Sorts a student file with a fixed memory budget:
+// ./statements_hints --sort <input> <output> <gpa|id|name> [memory in MB]
+int run_sort_file(const std::string& input, const std::string& output, const std::string& key_name,
+                  size_t memory_mb) {
+    StudentSortKey key;
+    if (key_name == "gpa") key = StudentSortKey::Gpa;
+    else if (key_name == "id") key = StudentSortKey::Id;
+    else if (key_name == "name") key = StudentSortKey::Name;
+    else {
+        std::cerr << "Unknown sort key: " << key_name << " (use gpa, id or name)\n";
+        return 1;
+    }
+
+    ExternalStudentSorter sorter(key, std::max<size_t>(memory_mb, 1) << 20);
+    int last_percent = -1;
+    size_t last_pass = 0;
+    sorter.set_progress([&](const SortProgress& p) {
+        int percent = p.bytes_total == 0 ? 100 : static_cast<int>(p.bytes_done * 100 / p.bytes_total);
+        if (p.pass == last_pass && percent / 10 == last_percent / 10) return;  // Every 10%
+        last_pass = p.pass;
+        last_percent = percent;
+        if (p.pass == 0) {
+            std::cerr << "  creating runs: " << percent << "% (" << p.runs << " runs)\n";
+        } else {
+            std::cerr << "  merge pass " << p.pass << ": " << percent << "% (" << p.runs << " runs)\n";
+        }
+    });
+
+    try {
+        SortResult result = sorter.sort(input, output);
+        std::cerr << "Sorted " << result.students << " students (" << result.runs << " runs, "
+                  << result.merge_passes << " merge passes, " << result.skipped_lines
+                  << " lines skipped)\n";
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
+
+void external_sort_demo() {
+    std::cout << "\n=== Performance: External Sort ===\n";
+
+    const std::string input = "sort_input.txt";
+    const std::string output = "sort_output.txt";
+    const int count = 300000;
+    {
+        std::vector<Student> roster;
+        roster.reserve(count);
+        for (int i = 0; i < count; ++i) {
+            int id = static_cast<int>((static_cast<long long>(i) * 7919) % count) + 1;  // Shuffled ids
+            Student student(id, "Student " + std::to_string((i * 31) % 1000));
+            for (int g = 0; g < 5; ++g) student.add_grade((i * 7 + g * 13) % 101);
+            roster.push_back(student);
+        }
+        StudentFileManager(input).save_students(roster, 0, true);  // With "#seq" header and index
+    }
+
+    using clock = std::chrono::steady_clock;
+    auto to_ms = [](clock::duration d) {
+        return std::chrono::duration<double, std::milli>(d).count();
+    };
+
+    // In memory: load everything, std::sort, save
+    auto start = clock::now();
+    std::vector<Student> students = StudentFileManager(input).load_students();
+    std::sort(students.begin(), students.end(), [](const Student& a, const Student& b) {
+        double gpa_a = a.calculate_gpa(), gpa_b = b.calculate_gpa();
+        return gpa_a > gpa_b || (gpa_a == gpa_b && a.get_id() < b.get_id());
+    });
+    double memory_ms = to_ms(clock::now() - start);
+
+    // External: at most 4 MB of lines in memory at a time
+    const size_t budget = size_t(4) << 20;
+    ExternalStudentSorter sorter(StudentSortKey::Gpa, budget);
+    int last_quarter = -1;
+    size_t last_pass = 0;
+    sorter.set_progress([&](const SortProgress& p) {
+        int quarter = p.bytes_total == 0 ? 4 : static_cast<int>(p.bytes_done * 4 / p.bytes_total);
+        if (p.pass == last_pass && quarter == last_quarter) return;
+        last_pass = p.pass;
+        last_quarter = quarter;
+        std::cout << "  " << (p.pass == 0 ? "runs" : "merge pass " + std::to_string(p.pass)) << ": "
+                  << quarter * 25 << "%, " << p.runs << " runs\n";
+    });
+    start = clock::now();
+    SortResult result = sorter.sort(input, output);
+    double external_ms = to_ms(clock::now() - start);
+
+    // Same order as std::sort? (The sorted file has no index, only students)
+    std::ifstream sorted(output);
+    std::string line;
+    size_t position = 0;
+    bool same = true;
+    while (std::getline(sorted, line)) {
+        same = same && position < students.size() && line == students[position].to_string();
+        ++position;
+    }
+    same = same && position == students.size();
+
+    std::cout << count << " students sorted by GPA:\n";
+    std::cout << "  load + std::sort (all in memory): " << memory_ms << " ms\n";
+    std::cout << "  external sort (" << (budget >> 20) << " MB budget): " << external_ms << " ms, "
+              << result.runs << " runs, " << result.merge_passes << " merge passes\n";
+    std::cout << "  same order: " << (same ? "yes" : "NO") << "\n";
+
+    // Lines load_students() accepts even without a name or grades
+    {
+        std::ofstream small(input, std::ios::binary);
+        small << "3,Cy,70\n1,Ann,90\n5\n2,Bob,80\n4,Dee\n";
+    }
+    ExternalStudentSorter by_name(StudentSortKey::Name);
+    by_name.sort(input, output);
+    std::ifstream small_sorted(output);
+    std::cout << "Short lines sorted by name:";
+    while (std::getline(small_sorted, line)) std::cout << "  [" << line << "]";
+    std::cout << "\n";
+
+    for (const std::string& name : {input, output}) {
+        for (const char* suffix : {"", ".tmp", ".journal", ".journal.old"}) {
+            std::remove((name + suffix).c_str());
+        }
+    }
+}
+
 // =============================================================================
 // MAIN FUNCTION - DEMONSTRATES ALL PROBLEMS
 // =============================================================================
@@ -710,7 +4136,16 @@ void create_sample_file() {
     file.close();
 }
 
-int main() {
+int main(int argc, char* argv[]) {
+    // Batch mode: ./statements_hints --batch <commands.txt or -> [data file]
+    if (argc >= 3 && std::string(argv[1]) == "--batch") {
+        return run_batch_file(argv[2], argc >= 4 ? argv[3] : "students_demo.txt");
+    }
+    // Sort mode: ./statements_hints --sort <input> <output> <gpa|id|name> [memory in MB]
+    if (argc >= 5 && std::string(argv[1]) == "--sort") {
+        return run_sort_file(argv[2], argv[3], argv[4], argc >= 6 ? std::strtoul(argv[5], nullptr, 10) : 64);
+    }
+
     std::cout << "=== Chapter 8: Statements - Homework Hints ===\n";
     std::cout << "This file demonstrates solutions to all problem sets.\n";
 
@@ -724,6 +4159,16 @@ int main() {
         std::cout << "4. Problem 2.1: Exception Handling\n";
         std::cout << "5. Problem 2.2: File Processing with RAII\n";
         std::cout << "6. Problem 3.1: Student Management System\n";
+        std::cout << "7. Performance: Single-Pass File Statistics\n";
+        std::cout << "8. Performance: Student Text Codec\n";
+        std::cout << "9. Performance: Parallel and Streaming Loader\n";
+        std::cout << "10. Performance: Journaled Persistence\n";
+        std::cout << "11. Performance: Indexed Student Roster\n";
+        std::cout << "12. Performance: Incremental GPA\n";
+        std::cout << "13. Performance: Batch Commands\n";
+        std::cout << "14. Performance: Loading Dirty Data\n";
+        std::cout << "15. Performance: Lazy Loading with an Index\n";
+        std::cout << "16. Performance: External Sort\n";
         std::cout << "0. Exit\n";
         std::cout << "Enter choice: ";
 
@@ -758,6 +4203,36 @@ int main() {
                 system.run();
                 break;
             }
+            case 7:
+                problem_2_2_file_statistics_benchmark();
+                break;
+            case 8:
+                student_codec_benchmark();
+                break;
+            case 9:
+                student_loader_benchmark();
+                break;
+            case 10:
+                journal_persistence_demo();
+                break;
+            case 11:
+                student_index_benchmark();
+                break;
+            case 12:
+                gpa_report_benchmark();
+                break;
+            case 13:
+                batch_command_benchmark();
+                break;
+            case 14:
+                dirty_data_benchmark();
+                break;
+            case 15:
+                lazy_loading_benchmark();
+                break;
+            case 16:
+                external_sort_demo();
+                break;
             case 0:
                 std::cout << "Goodbye!\n";
                 break;
@@ -793,6 +4268,7 @@ KEY LEARNING POINTS FROM CHAPTER 8
    - Automatic cleanup even when exceptions occur
    - Delete copy constructor/assignment for unique resources
    - File streams use RAII automatically
+   - The same idea wraps OS resources: MappedFile unmaps in its destructor
 
 4. BEST PRACTICES:
    - Validate all user input
@@ -808,15 +4284,69 @@ KEY LEARNING POINTS FROM CHAPTER 8
    - File I/O with automatic cleanup
    - Container iteration with range-based for
 
+6. PERFORMANCE (BEYOND THE ASSIGNMENT):
+   - Compute everything you need in ONE pass instead of re-reading a file
+   - Avoid per-character stream calls on large inputs; process blocks
+   - Memory-mapping (mmap) lets you scan a file as one big char array
+   - Split big inputs into chunks for worker threads, and take care at the
+     chunk boundaries (a word may cross them)
+   - Creating a string stream per line is expensive; std::to_chars and
+     std::from_chars convert numbers in place without allocating
+   - When optimizing, keep behavior identical: fall back to the original
+     conversion (stoi/stod) for rare edge cases instead of reimplementing them
+   - Parallel loading: split at line boundaries, let each thread fill its
+     own vector, then merge in order (and report problems in order)
+   - A streaming callback (for_each_student) handles files larger than RAM
+   - Don't rewrite everything to save one change: append it to a journal,
+     and compact (rewrite base file + start a new journal) now and then
+   - Write the new file under a temporary name and rename it over the old
+     one, so a crash never leaves a half-written data file
+   - Slow work like compaction can run on a background thread if it
+     shares nothing with the foreground: the new base file is built from
+     the old base file + the journal, not from the live roster
+   - Index what you search for: a hash map id -> slot makes lookup O(1),
+     and reusing freed slots means removing never shifts other elements
+   - An order-statistic tree (subtree sizes in every node) answers "how
+     many are better than X?" in O(log n) instead of counting them all
+   - Keep derived values (like a GPA's point sum) up to date as the data
+     changes, instead of recomputing them from scratch on every read
+   - constexpr tables are built by the compiler and cost nothing at run time
+   - Separate the logic from the user interface: the same core operations
+     serve the interactive menu and a batch mode that replays command files
+   - Report latency as percentiles (p50, p99, max), not only the average
+   - Exceptions are for rare errors. When bad input is common (dirty data
+     files), return the error as a value (Expected<T>) - and keep the
+     throwing API as a thin wrapper for existing callers
+   - Don't load what you may never use: an index at the end of the file
+     lets you read single records on demand, and an LRU cache keeps the
+     recently used ones in memory with a fixed size limit
+   - Files larger than memory can still be sorted: sort pieces that fit
+     (runs), then merge the runs; a loser tree finds the next line in
+     log2(k) comparisons
+   - Let helper threads read ahead and write behind, so the CPU work and
+     the disk work overlap
+
 =============================================================================
 COMPILATION AND RUNNING:
 =============================================================================
 
 To compile:
-    g++ -std=c++17 -Wall -Wextra statements_hints.cpp -o statements_hints
+    g++ -std=c++17 -Wall -Wextra -pthread statements_hints.cpp -o statements_hints
+
+For the performance demos (menu 7-16) add -O2 to see realistic timings.
+With -O3 the compiler also turns grade_points::total() into SIMD code.
+
+The Student Management System (menu 6) keeps its data in students_demo.txt
+plus students_demo.txt.journal (changes since the last compaction).
 
 To run:
     ./statements_hints
 
+Batch mode (commands from a file, or "-" for standard input):
+    ./statements_hints --batch commands.txt [data file]
+
+Sorting a student file that may not fit in memory (default budget 64 MB):
+    ./statements_hints --sort students.txt sorted.txt gpa|id|name [memory in MB]
+
 This demonstrates complete, working solutions for all Chapter 8 problems.
 */
@@ -4,6 +4,11 @@
 #include <vector>
 #include <unordered_map>
 #include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <new>
+#include <string_view>
 
 // =============================================================================
 // PROBLEM SET 1: BASIC SMART POINTER USAGE
@@ -693,6 +698,317 @@ void test_problem_3_2() {
     std::cout << std::endl;
 }
 
+// =============================================================================
+// PERFORMANCE EXTENSION: Pooled, Hash-Dispatched Shape Factory
+// =============================================================================
+
+// -----------------------------------------------------------------------------
+// Why ShapeFactory is slow at scale
+// -----------------------------------------------------------------------------
+// ShapeFactory::create_shape compares the type name against every known name
+// in turn, then make_unique performs a separate heap allocation per shape.
+// Loading a scene with millions of shapes repeats both costs millions of times.
+//
+// PooledShapeFactory fixes both:
+// 1. Type names are resolved by a PERFECT HASH computed at compile time:
+//    one hash + one string compare, no matter how many types exist
+// 2. Objects live in per-type OBJECT POOLS: big blocks allocated rarely,
+//    slots recycled through a free list
+// 3. Shapes are still returned as unique_ptr - with a CUSTOM DELETER that
+//    returns the slot to its pool instead of calling delete
+
+// FNV-1a hash - constexpr, so it can run inside the compiler
+constexpr std::uint32_t fnv1a(std::string_view text, std::uint32_t seed) {
+    std::uint32_t hash = 2166136261u ^ seed;
+    for (char c : text) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+namespace shape_registry {
+
+// Adding a type: append its name here, and its creator and pool in
+// PooledShapeFactory (the creators and pools() tables)
+constexpr std::array<std::string_view, 2> type_names = {"circle", "rectangle"};
+constexpr std::size_t table_size = 4;  // Power of two >= number of names
+
+// Does 'seed' send every name to a different slot?
+constexpr bool is_perfect(std::uint32_t seed) {
+    std::array<bool, table_size> used{};
+    for (std::string_view name : type_names) {
+        std::size_t slot = fnv1a(name, seed) & (table_size - 1);
+        if (used[slot]) return false;
+        used[slot] = true;
+    }
+    return true;
+}
+
+// Try seeds until one has no collisions - all at compile time
+constexpr std::uint32_t find_perfect_seed() {
+    for (std::uint32_t seed = 1; seed < 100000; ++seed) {
+        if (is_perfect(seed)) return seed;
+    }
+    return 0;
+}
+
+constexpr std::uint32_t seed = find_perfect_seed();
+static_assert(seed != 0, "No perfect hash seed found - increase table_size");
+
+// slot -> index into type_names, or -1 for an empty slot
+constexpr std::array<int, table_size> build_slots() {
+    std::array<int, table_size> slots{};
+    for (auto& slot : slots) slot = -1;
+    for (std::size_t i = 0; i < type_names.size(); ++i) {
+        slots[fnv1a(type_names[i], seed) & (table_size - 1)] = static_cast<int>(i);
+    }
+    return slots;
+}
+
+constexpr std::array<int, table_size> slots = build_slots();
+
+// Returns the type index for 'name', or -1 if the name is unknown
+constexpr int lookup(std::string_view name) {
+    int index = slots[fnv1a(name, seed) & (table_size - 1)];
+    // The hash picks the ONLY candidate; one compare confirms it
+    return (index >= 0 && type_names[static_cast<std::size_t>(index)] == name) ? index : -1;
+}
+
+static_assert(lookup("circle") == 0 && lookup("rectangle") == 1 && lookup("triangle") == -1,
+              "Perfect hash table is inconsistent");
+
+}  // namespace shape_registry
+
+// -----------------------------------------------------------------------------
+// Object pools and the pool-returning deleter
+// -----------------------------------------------------------------------------
+
+// Common base so one deleter type works for every pool
+class ShapePool {
+public:
+    virtual void destroy(Shape* shape) = 0;
+    virtual void reserve(std::size_t count) = 0;
+
+protected:
+    ~ShapePool() = default;
+};
+
+struct PoolDeleter {
+    ShapePool* pool = nullptr;
+
+    void operator()(Shape* shape) const {
+        pool->destroy(shape);  // Runs the destructor and recycles the slot
+    }
+};
+
+using PooledShape = std::unique_ptr<Shape, PoolDeleter>;
+
+template<typename T>
+class ObjectPool : public ShapePool {
+private:
+    // A free slot stores the link to the next free slot; a used slot stores a T
+    union Slot {
+        Slot* next;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    std::vector<std::unique_ptr<Slot[]>> chunks;
+    Slot* free_list = nullptr;
+    std::size_t free_count = 0;
+    std::size_t chunk_size;
+
+    void grow(std::size_t count) {
+        chunks.push_back(std::make_unique<Slot[]>(count));
+        Slot* chunk = chunks.back().get();
+        // Link back to front so slots are handed out in address order
+        for (std::size_t i = count; i-- > 0;) {
+            chunk[i].next = free_list;
+            free_list = &chunk[i];
+        }
+        free_count += count;
+    }
+
+public:
+    explicit ObjectPool(std::size_t slots_per_chunk = 4096) : chunk_size(slots_per_chunk) {}
+
+    // The pool owns the memory of every object it created, so it must
+    // outlive them (just like a container outlives its elements)
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+
+    // Make sure 'count' more objects can be created without allocating
+    void reserve(std::size_t count) override {
+        if (count > free_count) grow(count - free_count);
+    }
+
+    template<typename... Args>
+    T* create(Args&&... args) {
+        if (free_list == nullptr) grow(chunk_size);
+        Slot* slot = free_list;
+        free_list = slot->next;
+        --free_count;
+        try {
+            return new (slot->storage) T(std::forward<Args>(args)...);  // Placement new
+        } catch (...) {
+            slot->next = free_list;  // Constructor threw - give the slot back
+            free_list = slot;
+            ++free_count;
+            throw;
+        }
+    }
+
+    void destroy(Shape* shape) override {
+        T* object = static_cast<T*>(shape);
+        object->~T();  // Explicit destructor call pairs with placement new
+        Slot* slot = reinterpret_cast<Slot*>(object);
+        slot->next = free_list;
+        free_list = slot;
+        ++free_count;
+    }
+};
+
+// -----------------------------------------------------------------------------
+// PooledShapeFactory
+// -----------------------------------------------------------------------------
+// Not thread-safe: use one factory per thread (e.g. one per loader thread).
+// The factory must outlive every shape it created.
+
+struct ShapeRecord {
+    std::string type;
+    double param1;
+    double param2;
+};
+
+class PooledShapeFactory {
+private:
+    ObjectPool<Circle> circles;
+    ObjectPool<Rectangle> rectangles;
+
+    PooledShape make_circle(double radius, double /* unused */) {
+        return PooledShape(circles.create(radius), PoolDeleter{&circles});
+    }
+
+    PooledShape make_rectangle(double width, double height) {
+        return PooledShape(rectangles.create(width, height), PoolDeleter{&rectangles});
+    }
+
+    // Creator table, indexed like shape_registry::type_names
+    using Creator = PooledShape (PooledShapeFactory::*)(double, double);
+    static constexpr std::array<Creator, shape_registry::type_names.size()> creators = {
+        &PooledShapeFactory::make_circle,
+        &PooledShapeFactory::make_rectangle,
+    };
+
+    // Pool table, indexed like shape_registry::type_names
+    std::array<ShapePool*, shape_registry::type_names.size()> pools() {
+        return {&circles, &rectangles};
+    }
+
+public:
+    // Same contract as ShapeFactory::create_shape: nullptr for unknown types
+    PooledShape create_shape(std::string_view type, double param1, double param2 = 0) {
+        int index = shape_registry::lookup(type);
+        if (index < 0) return nullptr;
+        return (this->*creators[static_cast<std::size_t>(index)])(param1, param2);
+    }
+
+    // Bulk creation: resolve every type first, reserve each pool once,
+    // then construct. Unknown types produce nullptr entries.
+    std::vector<PooledShape> create_shapes(const std::vector<ShapeRecord>& records) {
+        std::vector<int> kinds(records.size());
+        std::array<std::size_t, shape_registry::type_names.size()> counts{};
+        for (std::size_t i = 0; i < records.size(); ++i) {
+            kinds[i] = shape_registry::lookup(records[i].type);
+            if (kinds[i] >= 0) ++counts[static_cast<std::size_t>(kinds[i])];
+        }
+        std::array<ShapePool*, shape_registry::type_names.size()> by_type = pools();
+        for (std::size_t type = 0; type < by_type.size(); ++type) {
+            by_type[type]->reserve(counts[type]);
+        }
+
+        std::vector<PooledShape> shapes;
+        shapes.reserve(records.size());
+        for (std::size_t i = 0; i < records.size(); ++i) {
+            if (kinds[i] < 0) {
+                shapes.emplace_back(nullptr, PoolDeleter{});
+            } else {
+                shapes.push_back((this->*creators[static_cast<std::size_t>(kinds[i])])(
+                    records[i].param1, records[i].param2));
+            }
+        }
+        return shapes;
+    }
+};
+
+void test_pooled_factory() {
+    std::cout << "=== Performance Extension: Pooled, Hash-Dispatched Factory ===\n";
+
+    PooledShapeFactory factory;
+
+    // Same calls as Problem 1.2 - same results, different machinery
+    auto circle = factory.create_shape("circle", 5.0);
+    auto rectangle = factory.create_shape("rectangle", 3.0, 4.0);
+    auto unknown = factory.create_shape("triangle", 1.0, 2.0);
+
+    if (circle) {
+        std::cout << "Circle area: " << circle->area() << std::endl;
+    }
+    if (rectangle) {
+        std::cout << "Rectangle area: " << rectangle->area() << std::endl;
+    }
+    if (!unknown) {
+        std::cout << "Unknown shape type" << std::endl;
+    }
+
+    // Bulk creation benchmark: a "scene" of many shapes
+    const std::size_t count = 1000000;
+    std::vector<ShapeRecord> scene;
+    scene.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        if (i % 2 == 0) {
+            scene.push_back({"circle", 1.0 + static_cast<double>(i % 7), 0.0});
+        } else {
+            scene.push_back({"rectangle", 2.0, 1.0 + static_cast<double>(i % 5)});
+        }
+    }
+
+    using clock = std::chrono::steady_clock;
+    auto to_ms = [](clock::duration d) {
+        return std::chrono::duration<double, std::milli>(d).count();
+    };
+
+    auto start = clock::now();
+    double area_plain = 0.0;
+    {
+        std::vector<std::unique_ptr<Shape>> shapes;
+        shapes.reserve(count);
+        for (const auto& record : scene) {
+            shapes.push_back(ShapeFactory::create_shape(record.type, record.param1, record.param2));
+        }
+        for (const auto& shape : shapes) area_plain += shape->area();
+    }  // Destruction included in the timing
+    auto plain_time = clock::now() - start;
+
+    start = clock::now();
+    double area_pooled = 0.0;
+    {
+        PooledShapeFactory scene_factory;
+        {
+            auto shapes = scene_factory.create_shapes(scene);
+            for (const auto& shape : shapes) area_pooled += shape->area();
+        }  // Shapes go back to the pools before the factory is destroyed
+    }
+    auto pooled_time = clock::now() - start;
+
+    std::cout << count << " shapes created, summed and destroyed:\n";
+    std::cout << "  ShapeFactory (string compares + make_unique): " << to_ms(plain_time)
+              << " ms (area " << area_plain << ")\n";
+    std::cout << "  PooledShapeFactory::create_shapes:            " << to_ms(pooled_time)
+              << " ms (area " << area_pooled << ")\n";
+    std::cout << std::endl;
+}
+
 // =============================================================================
 // MAIN FUNCTION - COMPREHENSIVE DEMONSTRATION
 // =============================================================================
@@ -715,6 +1031,9 @@ int main() {
     test_problem_3_1();
     test_problem_3_2();
 
+    // Performance Extension
+    test_pooled_factory();
+
     std::cout << "========================================\n";
     std::cout << "ALL TESTS COMPLETED\n";
     std::cout << "========================================\n";
@@ -775,6 +1094,8 @@ KEY LEARNING POINTS: SMART POINTERS
    - shared_ptr: Atomic reference counting overhead
    - weak_ptr: Must lock() to access (small overhead)
    - make_shared: Single allocation for object + control block
+   - unique_ptr with a custom deleter can hand objects back to a pool
+     instead of deleting them (see PooledShapeFactory)
 
 =============================================================================
 */